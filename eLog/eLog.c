@@ -14,23 +14,70 @@
 #include "mutex_common.h"
 #include <inttypes.h>  // For PRIu32 macro
 #include <stdarg.h>
+#include <stddef.h>  // For ptrdiff_t (ISR argument rendering)
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>      // For clock_gettime (host timestamp source)
+#endif
+#if ELOG_CONSOLE_RING_TX
+#include "ring_tx.h"
+#endif
+
+/* Formatter backend */
+#if (ELOG_USE_BUILTIN_PRINTF == YES)
+#define ELOG_VSNPRINTF elog_vsnprintf
+#define ELOG_SNPRINTF  elog_snprintf
+#else
+#define ELOG_VSNPRINTF vsnprintf
+#define ELOG_SNPRINTF  snprintf
+#endif
 
 /* ========================================================================== */
-/* Running number */
+/* Running numbers: per module, plus one global sequence across all modules */
 volatile uint32_t s_log_runing_number[ELOG_MD_MAX] = {0};
+static volatile uint32_t s_log_global_number = 0;
+
+/**
+ * @brief Lock-free increment-and-fetch used for sequence allocation
+ * @note  ARMv7-M/ARMv8-M Mainline use an LDREX/STREX retry loop, ARMv6-M/ARMv8-M Baseline
+ *        (no exclusives) mask interrupts for the read-modify-write, everything else uses
+ *        the compiler's __atomic builtins (C11 memory model).
+ * @param counter: Counter to increment
+ * @return Incremented value, unique per caller
+ */
+static inline uint32_t elog_seq_next(volatile uint32_t *counter)
+{
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+  uint32_t value;
+  uint32_t failed;
+  do
+  {
+    __asm volatile("ldrex %0, [%1]" : "=r"(value) : "r"(counter) : "memory");
+    value++;
+    __asm volatile("strex %0, %2, [%1]" : "=&r"(failed) : "r"(counter), "r"(value) : "memory");
+  } while (failed != 0u);
+  return value;
+#elif defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_8M_BASE__)
+  uint32_t primask;
+  __asm volatile("mrs %0, primask\n cpsid i" : "=r"(primask) : : "memory");
+  uint32_t value = *counter + 1u;
+  *counter = value;
+  __asm volatile("msr primask, %0" : : "r"(primask) : "memory");
+  return value;
+#else
+  return __atomic_add_fetch(counter, 1u, __ATOMIC_RELAXED);
+#endif
+}
 
-static uint32_t inline get_runing_nbr(elog_module_t module)
+static inline uint32_t get_runing_nbr(elog_module_t module)
 {
   if (module >= ELOG_MD_MAX)
   {
     return 0;
   }
-
-  // Simple increment - no atomic operations for now to diagnose issue
-  return ++s_log_runing_number[module];
+  return elog_seq_next(&s_log_runing_number[module]);
 }
 
 /* ========================================================================== */
@@ -42,27 +89,157 @@ static uint32_t inline get_runing_nbr(elog_module_t module)
  */
 typedef struct
 {
-  log_subscriber_t fn;
+  log_subscriber_t fn;                /* Text subscriber, or NULL */
+  elog_record_subscriber_t record_fn; /* Record subscriber, or NULL */
   elog_level_t threshold;
+  elog_module_mask_t module_mask;
+  elog_backpressure_t *bp;            /* Policy for refused lines (text subscribers), or NULL */
 } subscriber_entry_t;
 
-/* Static storage for subscribers */
-static subscriber_entry_t s_subscribers[ELOG_MAX_SUBSCRIBERS];
-static int s_num_subscribers = 0;
+/* Bitmap of subscriber slots; one bit per entry in a subscriber table */
+#if (ELOG_MAX_SUBSCRIBERS <= 8)
+typedef uint8_t elog_sub_mask_t;
+#elif (ELOG_MAX_SUBSCRIBERS <= 16)
+typedef uint16_t elog_sub_mask_t;
+#else
+typedef uint32_t elog_sub_mask_t;
+#endif
+
+/* Compile-time checks: module ids must fit the module mask, slots must fit the slot bitmap */
+typedef char elog_module_mask_width_check[(ELOG_MD_MAX <= sizeof(elog_module_mask_t) * 8u) ? 1 : -1];
+typedef char elog_sub_mask_width_check[(ELOG_MAX_SUBSCRIBERS <= 32) ? 1 : -1];
+
+/**
+ * @brief Subscriber table
+ * @note  dispatch[module][level - ELOG_LEVEL_TRACE] holds the slots that accept that record;
+ *        row ELOG_MD_MAX covers module ids outside the enum. Rebuilt on every publish.
+ */
+typedef struct
+{
+  subscriber_entry_t entries[ELOG_MAX_SUBSCRIBERS];
+  int count;
+  elog_sub_mask_t dispatch[ELOG_MD_MAX + 1][ELOG_LEVEL_COUNT];
+} subscriber_table_t;
+
+/**
+ * @brief Reader-side copy of the entries needed to deliver one record
+ */
+typedef struct
+{
+  subscriber_entry_t entries[ELOG_MAX_SUBSCRIBERS];
+  elog_sub_mask_t mask;
+} subscriber_snapshot_t;
+
+/*
+ * Double-buffered subscriber table.
+ * The published table is s_sub_tables[s_sub_generation & 1]. Writers (subscribe/unsubscribe)
+ * fill the other table and publish it with a single atomic store of the incremented
+ * generation; they never touch the table readers are using and never wait for readers.
+ * Readers copy the published table and retry only if a publish happened during the copy.
+ */
+static subscriber_table_t s_sub_tables[2];
+static volatile uint32_t s_sub_generation = 0;
 
-/* Static message buffer for formatting */
-static char s_fmt[ELOG_MAX_MESSAGE_LENGTH];
+/* Static message buffer for formatting (prefix and user message are composed in place) */
 static char s_full_message_buffer[ELOG_FULL_MESSAGE_LENGTH];
 
-/* Mutex for thread safety */
+/* Mutex for thread safety: s_log_mutex guards formatting, s_sub_mutex serializes table writers */
 static volatile void *s_log_mutex;
+static volatile void *s_sub_mutex;
+
+/* Per-module thresholds as set by elog_set_module_threshold() / elog_set_levels() (atomic bytes) */
+static uint8_t s_module_user_thresholds[ELOG_MD_MAX];
+
+/* Lowest level any subscriber accepts per module, rebuilt under s_sub_mutex (see elog_update_gates) */
+static uint8_t s_module_sub_floors[ELOG_MD_MAX];
+
+/* Effective per-module gate, read inline by the ELOG_* macros (see ELOG_LEVEL_ENABLED):
+ * max(module threshold, lowest level any subscriber accepts for the module) */
+uint8_t elog_module_thresholds[ELOG_MD_MAX];
 
+/* Gate value for a module no subscriber listens to: above every level */
+#define ELOG_GATE_CLOSED 0xFFu
+
+/* Runtime counters (see elog_get_stats) */
+static elog_stats_t s_stats;
+
+#if (ELOG_SAMPLING_ENABLE == YES)
+/* Per-module sampling: rate N in bits 0-15, elog_sample_mode_t in bits 16-23 (one atomic word) */
+static uint32_t s_sample_config[ELOG_MD_MAX];
+static uint32_t s_sample_count[ELOG_MD_MAX];
+static uint32_t s_sample_rng = 0x9E3779B9u;
+#endif
+
+/* Timestamp source (see elog_set_timestamp_source) */
+static elog_timestamp_fn_t s_ts_source;
+static uint32_t s_ts_rate;
+
+#if (ELOG_ISR_ENABLE == YES)
+/* Interrupt-context capture queue (bounded MPSC, per-slot turn counters).
+ * A producer owns position pos once it moves s_isr_head from pos to pos + 1 while
+ * slot.turn == pos; it publishes with turn = pos + 1. The drain task consumes position
+ * s_isr_tail when turn == tail + 1 and frees the slot for the next lap with turn = tail + LEN. */
 typedef struct
 {
-  elog_level_t threshold;
-} module_log_level_entry_t;
+  uint32_t turn;
+  const char *fmt;
+  const char *file;   /* Call site (static strings) */
+  const char *func;
+  int line;
+  uint32_t timestamp;
+  uint16_t sample_rate;
+  uint8_t module;
+  uint8_t level;
+  uint8_t has_timestamp;
+  uint8_t nargs;
+  elog_arg_t args[ELOG_ISR_MAX_ARGS];
+} elog_isr_slot_t;
+
+typedef char elog_isr_queue_len_check[((ELOG_ISR_QUEUE_LEN & (ELOG_ISR_QUEUE_LEN - 1)) == 0) ? 1 : -1];
+
+static elog_isr_slot_t s_isr_queue[ELOG_ISR_QUEUE_LEN];
+static uint32_t s_isr_head;         /* Next producer position */
+static uint32_t s_isr_tail;         /* Next consumer position (elog_isr_drain, under s_log_mutex) */
+static uint32_t s_isr_dropped;      /* Losses not yet reported by elog_isr_drain */
+static char s_isr_message[ELOG_MAX_MESSAGE_LENGTH];
+#endif
+
+#if (ELOG_COALESCE_ENABLE == YES)
+/* Recently logged messages, guarded by s_log_mutex (see elog_coalesce) */
+typedef struct
+{
+  const char *fmt;
+  uint32_t hash;     /* elog_fmt_hash_args() of the arguments */
+  uint32_t first_ts; /* Start of the current window */
+  uint32_t repeats;  /* Identical records absorbed since the last full line */
+  uint8_t module;
+  uint8_t level;
+} coalesce_slot_t;
 
-static module_log_level_entry_t module_log_levels[ELOG_MD_MAX];
+static coalesce_slot_t s_coalesce[ELOG_COALESCE_SLOTS];
+static uint8_t s_coalesce_next;
+#endif
+
+/* Atomic access helpers (GCC/Clang builtins, available on every supported toolchain) */
+#define ELOG_ATOMIC_LOAD(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ELOG_ATOMIC_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ELOG_ATOMIC_FENCE()     __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define ELOG_ATOMIC_INC(p)      __atomic_add_fetch((p), 1u, __ATOMIC_RELAXED)
+
+/* Interrupt-context test for the ISR fast path (IPSR exception number on Cortex-M) */
+#ifndef ELOG_IN_ISR
+#if defined(__arm__)
+__attribute__((always_inline)) static inline uint32_t elog_ipsr(void)
+{
+  uint32_t ipsr;
+  __asm volatile("mrs %0, ipsr" : "=r"(ipsr));
+  return ipsr & 0x1FFu;
+}
+#define ELOG_IN_ISR() (elog_ipsr() != 0u)
+#else
+#define ELOG_IN_ISR() 0
+#endif
+#endif
 
 /* ========================================================================== */
 /* Enhanced Logging Core Implementation */
@@ -74,43 +251,198 @@ static module_log_level_entry_t module_log_levels[ELOG_MD_MAX];
 void elog_init(void)
 {
   /* Clear all subscribers */
-  for (int i = 0; i < ELOG_MAX_SUBSCRIBERS; i++)
-  {
-    s_subscribers[i].fn = NULL;
-    s_subscribers[i].threshold = ELOG_LEVEL_ALWAYS;
-  }
-  s_num_subscribers = 0;
+  memset(s_sub_tables, 0, sizeof(s_sub_tables));
+  ELOG_ATOMIC_STORE(&s_sub_generation, 0u);
   
-  /* Clear module log levels */
+  /* Clear module log levels (gates stay closed until a subscriber is added) */
   for (int i = 0; i < ELOG_MD_MAX; i++)
   {
-    module_log_levels[i].threshold = ELOG_DEFAULT_THRESHOLD;
+    s_module_user_thresholds[i] = (uint8_t)ELOG_DEFAULT_THRESHOLD;
+    s_module_sub_floors[i] = (uint8_t)ELOG_GATE_CLOSED;
+    elog_module_thresholds[i] = (uint8_t)ELOG_GATE_CLOSED;
+  }
+  memset(&s_stats, 0, sizeof(s_stats));
+#if (ELOG_ISR_ENABLE == YES)
+  for (uint32_t i = 0; i < ELOG_ISR_QUEUE_LEN; i++)
+  {
+    s_isr_queue[i].turn = i;
   }
+  s_isr_head = 0;
+  s_isr_tail = 0;
+  s_isr_dropped = 0;
+#endif
+#if (ELOG_SAMPLING_ENABLE == YES)
+  memset(s_sample_config, 0, sizeof(s_sample_config));
+  memset(s_sample_count, 0, sizeof(s_sample_count));
+#endif
+#if (ELOG_COALESCE_ENABLE == YES)
+  memset(s_coalesce, 0, sizeof(s_coalesce));
+  s_coalesce_next = 0;
+#endif
 }
 
-static bool inline elog_enter_cs(void){
+static bool inline elog_enter_cs(volatile void **mutex){
   if (utilities_is_RTOS_ready()) {
     // Try to take mutex if it was successfully created
-    if (s_log_mutex != NULL) {
-      if (utilities_mutex_take((void *)s_log_mutex, ELOG_MUTEX_TIMEOUT_MS) == MUTEX_OK) {
+    if (*mutex != NULL) {
+      if (utilities_mutex_take((void *)*mutex, ELOG_MUTEX_TIMEOUT_MS) == MUTEX_OK) {
         return true;
       }
     }
 
     // Lazy create mutex on first use
-    if (s_log_mutex == NULL) {
-      s_log_mutex = utilities_mutex_create();
+    if (*mutex == NULL) {
+      *mutex = utilities_mutex_create();
     }
   }
   return false;
 }
 
-static void inline elog_exit_cs(bool took_mutex){
+static void inline elog_exit_cs(volatile void **mutex, bool took_mutex){
   if (took_mutex) {
-    utilities_mutex_give((void *)s_log_mutex);
+    utilities_mutex_give((void *)*mutex);
+  }
+}
+
+/* ========================================================================== */
+/* Subscriber Table Publication */
+/* ========================================================================== */
+
+/**
+ * @brief Index of the dispatch row for a module (out-of-range ids share the last row)
+ */
+static inline unsigned elog_dispatch_row(elog_module_t module)
+{
+  return ((unsigned)module < (unsigned)ELOG_MD_MAX) ? (unsigned)module : (unsigned)ELOG_MD_MAX;
+}
+
+/**
+ * @brief Subscriber slots accepting a record, read from the published table (lock-free)
+ * @note  A single load; used to reject records before any formatting work.
+ */
+static inline elog_sub_mask_t elog_subs_wanted(elog_module_t module, elog_level_t level)
+{
+  if (level < ELOG_LEVEL_TRACE || level > ELOG_LEVEL_ALWAYS) { return 0; }
+  uint32_t gen = ELOG_ATOMIC_LOAD(&s_sub_generation);
+  return s_sub_tables[gen & 1u].dispatch[elog_dispatch_row(module)][level - ELOG_LEVEL_TRACE];
+}
+
+/**
+ * @brief Take a consistent copy of the subscribers accepting a record (lock-free)
+ * @param snap: Destination snapshot; snap->mask selects the valid entries
+ * @param module: Record module
+ * @param level: Record level
+ */
+static void elog_subs_snapshot(subscriber_snapshot_t *snap, elog_module_t module, elog_level_t level)
+{
+  uint32_t gen;
+  do
+  {
+    gen = ELOG_ATOMIC_LOAD(&s_sub_generation);
+    const subscriber_table_t *t = &s_sub_tables[gen & 1u];
+    elog_sub_mask_t mask = t->dispatch[elog_dispatch_row(module)][level - ELOG_LEVEL_TRACE];
+    snap->mask = mask;
+    for (int i = 0; mask != 0; i++, mask >>= 1)
+    {
+      if (mask & 1u) { snap->entries[i] = t->entries[i]; }
+    }
+    ELOG_ATOMIC_FENCE();
+  } while (gen != __atomic_load_n(&s_sub_generation, __ATOMIC_RELAXED));
+}
+
+/**
+ * @brief Recompute the per-(module, level) dispatch bitmap of a table
+ */
+static void elog_subs_rebuild(subscriber_table_t *t)
+{
+  memset(t->dispatch, 0, sizeof(t->dispatch));
+  for (int i = 0; i < t->count; i++)
+  {
+    const subscriber_entry_t *e = &t->entries[i];
+    for (unsigned row = 0; row <= (unsigned)ELOG_MD_MAX; row++)
+    {
+      bool selected = (row < (unsigned)ELOG_MD_MAX) ? ((e->module_mask & ELOG_MODULE_BIT(row)) != 0)
+                                                    : (e->module_mask == ELOG_MODULE_MASK_ALL);
+      if (!selected) { continue; }
+      for (int lvl = 0; lvl < ELOG_LEVEL_COUNT; lvl++)
+      {
+        if (ELOG_LEVEL_TRACE + lvl >= (int)e->threshold)
+        {
+          t->dispatch[row][lvl] |= (elog_sub_mask_t)(1u << i);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Start a table update: copy the published table into the spare one
+ * @note  Caller must hold s_sub_mutex (or be the only writer)
+ * @return Spare table to modify, then pass to elog_subs_publish()
+ */
+static subscriber_table_t *elog_subs_begin_update(void)
+{
+  uint32_t gen = s_sub_generation;
+  subscriber_table_t *next = &s_sub_tables[(gen + 1u) & 1u];
+  *next = s_sub_tables[gen & 1u];
+  return next;
+}
+
+/**
+ * @brief Recompute one module's gate from its subscriber floor and user threshold, without locks
+ * @param m: Module index
+ * @note Runs concurrently from elog_set_module_threshold() and elog_update_gates(). Every input
+ *       store precedes the writer's gate store (sequentially consistent), so the writer whose gate
+ *       store lands last re-reads any input that changed under it and publishes again.
+ */
+static void elog_gate_refresh(int m)
+{
+  for (;;)
+  {
+    uint8_t floor = __atomic_load_n(&s_module_sub_floors[m], __ATOMIC_SEQ_CST);
+    uint8_t user = __atomic_load_n(&s_module_user_thresholds[m], __ATOMIC_SEQ_CST);
+    __atomic_store_n(&elog_module_thresholds[m], (floor > user) ? floor : user, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&s_module_sub_floors[m], __ATOMIC_SEQ_CST) == floor &&
+        __atomic_load_n(&s_module_user_thresholds[m], __ATOMIC_SEQ_CST) == user)
+    {
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Recompute the inline gate of every module from its threshold and the published table
+ * @note  Caller must hold s_sub_mutex (or be the only writer)
+ */
+static void elog_update_gates(void)
+{
+  const subscriber_table_t *t = &s_sub_tables[s_sub_generation & 1u];
+  for (int m = 0; m < ELOG_MD_MAX; m++)
+  {
+    /* Lowest level any subscriber accepts for this module */
+    uint8_t floor = (uint8_t)ELOG_GATE_CLOSED;
+    for (int lvl = 0; lvl < ELOG_LEVEL_COUNT; lvl++)
+    {
+      if (t->dispatch[m][lvl] != 0)
+      {
+        floor = (uint8_t)(ELOG_LEVEL_TRACE + lvl);
+        break;
+      }
+    }
+    __atomic_store_n(&s_module_sub_floors[m], floor, __ATOMIC_SEQ_CST);
+    elog_gate_refresh(m);
   }
 }
 
+/**
+ * @brief Rebuild the spare table's dispatch bitmap and publish it with a single atomic store
+ */
+static void elog_subs_publish(subscriber_table_t *next)
+{
+  elog_subs_rebuild(next);
+  ELOG_ATOMIC_STORE(&s_sub_generation, s_sub_generation + 1u);
+  elog_update_gates();
+}
 
 /**
  * @brief Get human-readable name for log level
@@ -132,16 +464,132 @@ const char *elog_level_name(elog_level_t level)
   }
 }
 
+/* Module names generated from the module list (see eLog_modules.h) */
+#define ELOG_MODULE_NAME(name) #name,
+static const char *const s_module_names[ELOG_MD_MAX] = { ELOG_MODULE_LIST(ELOG_MODULE_NAME) };
+#undef ELOG_MODULE_NAME
+
+/**
+ * @brief Get the name of a module as spelled in the module list
+ * @param module: Module identifier
+ * @return Module name, or "?" for ids outside the list
+ */
+const char *elog_module_name(elog_module_t module)
+{
+  return ((unsigned)module < (unsigned)ELOG_MD_MAX) ? s_module_names[module] : "?";
+}
+
+/**
+ * @brief Look up a module by name (case-insensitive)
+ * @param name: Module name
+ * @param len: Name length
+ * @return Module identifier, or ELOG_MD_MAX if no module has that name
+ */
+elog_module_t elog_module_from_name(const char *name, size_t len)
+{
+  if (name == NULL) { return ELOG_MD_MAX; }
+  for (int m = 0; m < ELOG_MD_MAX; m++)
+  {
+    const char *candidate = s_module_names[m];
+    size_t i = 0;
+    while (i < len && candidate[i] != '\0' && (name[i] & ~0x20) == (candidate[i] & ~0x20)) { i++; }
+    if (i == len && candidate[i] == '\0') { return (elog_module_t)m; }
+  }
+  return ELOG_MD_MAX;
+}
+
 /**
  * @brief Get the automatically calculated threshold level
  * @return The ELOG_DEFAULT_THRESHOLD value
  */
 elog_level_t elog_get_auto_threshold(void) { return ELOG_DEFAULT_THRESHOLD; }
 
+/* ========================================================================== */
+/* Timestamps */
+/* ========================================================================== */
+
+/**
+ * @brief Register the timestamp source sampled at elog_message entry
+ * @param fn: Tick source, or NULL to disable timestamps
+ * @param ticks_per_sec: Source rate
+ */
+void elog_set_timestamp_source(elog_timestamp_fn_t fn, uint32_t ticks_per_sec)
+{
+  ELOG_ATOMIC_STORE(&s_ts_rate, (fn != NULL) ? ticks_per_sec : 0u);
+  ELOG_ATOMIC_STORE(&s_ts_source, fn);
+}
+
+/**
+ * @brief Get the rate of the registered timestamp source
+ * @return Ticks per second, or 0 when no source is registered
+ */
+uint32_t elog_get_timestamp_rate(void) { return ELOG_ATOMIC_LOAD(&s_ts_rate); }
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define ELOG_DEMCR      (*(volatile uint32_t *)0xE000EDFCu)
+#define ELOG_DWT_CTRL   (*(volatile uint32_t *)0xE0001000u)
+#define ELOG_DWT_CYCCNT (*(volatile uint32_t *)0xE0001004u)
+
+static uint32_t elog_timestamp_cycles(void) { return ELOG_DWT_CYCCNT; }
+
+/**
+ * @brief Enable the DWT cycle counter and use it as the timestamp source
+ * @param core_hz: Core clock frequency
+ */
+void elog_timestamp_use_cycle_counter(uint32_t core_hz)
+{
+  ELOG_DEMCR |= (1u << 24);    /* TRCENA */
+  ELOG_DWT_CTRL |= 1u;         /* CYCCNTENA */
+  elog_set_timestamp_source(elog_timestamp_cycles, core_hz);
+}
+#elif defined(__unix__) || defined(__APPLE__)
+static uint32_t elog_timestamp_monotonic_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+}
+
+/**
+ * @brief Use CLOCK_MONOTONIC in microseconds as the timestamp source (host builds)
+ */
+void elog_timestamp_use_monotonic_clock(void)
+{
+  elog_set_timestamp_source(elog_timestamp_monotonic_us, 1000000u);
+}
+#endif
+
 /* ========================================================================== */
 /* Built-in Console Subscriber */
 /* ========================================================================== */
 
+#if ELOG_CONSOLE_RING_TX
+static struct ring_tx *s_console_tx = NULL;
+
+void elog_console_attach(struct ring_tx *tx)
+{
+  ELOG_ATOMIC_STORE(&s_console_tx, tx);
+}
+
+/**
+ * @brief Built-in console log subscriber
+ * @param handle: Unused
+ * @param buf: Message buffer
+ * @param len: Length of message
+ * @return 0 if queued, -1 if no transmitter is attached or its ring is full
+ */
+int elog_console_subscriber(int handle, const char *buf, size_t len)
+{
+  (void)handle;
+  struct ring_tx *tx = ELOG_ATOMIC_LOAD(&s_console_tx);
+  if (tx == NULL)
+  {
+    return -1;
+  }
+  /* Queue into the ring; the DMA engine chains spans from its TX-complete interrupt */
+  return (ring_tx_write(tx, buf, (uint32_t)len) == (uint32_t)len) ? 0 : -1;
+}
+#else
 /**
  * @brief Built-in console log subscriber
  * @param handle: Unused
@@ -155,224 +603,1448 @@ int elog_console_subscriber(int handle, const char *buf, size_t len)
   /* Redirect to UART Tx DMA */
   return LPUartQueueBuffWrite(handle, buf, len);
 }
+#endif
 
 /* ========================================================================== */
-/* Thread Safety Implementation */
+/* Message Composition */
 /* ========================================================================== */
 
-#if ENABLE_DEBUG_MESSAGES_WITH_LOCATION
+#if ELOG_USE_COLOR
+/* Color codes indexed by (level - ELOG_LEVEL_TRACE) */
+static const char *const s_level_colors[] = {
+    LOG_COLOR(LOG_COLOR_BLUE),  /* Blue for trace */
+    LOG_COLOR(LOG_COLOR_GREEN), /* Green for info */
+    LOG_COLOR(LOG_COLOR_CYAN),  /* Cyan for debug */
+    LOG_COLOR(LOG_COLOR_BROWN), /* Brown/Yellow for warning */
+    LOG_COLOR(LOG_COLOR_RED),   /* Red for error */
+    LOG_BOLD(LOG_COLOR_RED),    /* Bold Red for critical */
+    LOG_BOLD("37")              /* Bold White for always */
+};
+#endif
+
+/* Non-printf content of a record: ELOG_HEXDUMP buffer, ELOG_KV fields or ELOG_SPAN event */
+typedef struct {
+  const uint8_t *data;
+  uint32_t data_len;
+  const elog_kv_t *fields;
+  uint32_t field_count;
+  uint8_t span;        /* ELOG_SPAN_PHASE_*, or 0 */
+  uint32_t span_start; /* End events: timestamp of the begin */
+} elog_attach_t;
+
+/* Marker for a record whose text has not been composed yet */
+#define ELOG_TEXT_PENDING (-2)
+
 /**
- * @brief Thread-safe version of log_message_with_location
- * @param level: Severity level of the message
- * @param file: Source file name
- * @param func: Function name
- * @param line: Line number
- * @param fmt: Printf-style format string
- * @param ...: Format arguments
+ * @brief Write the record prefix ("<color><level>:<module>,<nbr>[@<ticks>][~<rate>]:") at the start of the message buffer
+ * @param rec: Record being formatted
+ * @param end_color: Receives the color reset sequence to append after the body
+ * @return Number of characters written
  */
-void elog_message_with_location(elog_module_t module, elog_level_t level, const char *file, const char *func,
-                                     int line, const char *fmt, ...)
+static int elog_format_prefix(const elog_record_t *rec, const char **end_color)
 {
-  if (level < elog_get_module_threshold(module))
+  const char *color_code = "";
+  *end_color = "";
+#if ELOG_USE_COLOR
+  if (rec->level >= ELOG_LEVEL_TRACE && rec->level <= ELOG_LEVEL_ALWAYS)
   {
-    return; // Skip log if below module threshold
+    color_code = s_level_colors[rec->level - ELOG_LEVEL_TRACE];
+    *end_color = LOG_RESET_COLOR;
   }
+#endif
+  int len;
+  if (rec->has_timestamp)
+  {
+    len = ELOG_SNPRINTF(s_full_message_buffer, sizeof(s_full_message_buffer), "%s%s:%u,%" PRIu32 "@%" PRIu32,
+                        color_code, elog_level_name(rec->level), (uint8_t)rec->module, rec->sequence, rec->timestamp);
+  }
+  else
+  {
+    len = ELOG_SNPRINTF(s_full_message_buffer, sizeof(s_full_message_buffer), "%s%s:%u,%" PRIu32,
+                        color_code, elog_level_name(rec->level), (uint8_t)rec->module, rec->sequence);
+  }
+  if (len < 0) { return 0; }
+  if (rec->sample_rate > 1u && (size_t)len < sizeof(s_full_message_buffer))
+  {
+    /* Sampled record: "~N" = this line stands for N records */
+    int n = ELOG_SNPRINTF(s_full_message_buffer + len, sizeof(s_full_message_buffer) - (size_t)len, "~%u",
+                          (unsigned)rec->sample_rate);
+    if (n > 0) { len += n; }
+  }
+  if ((size_t)len + 1u >= sizeof(s_full_message_buffer)) { return (int)sizeof(s_full_message_buffer) - 1; }
+  s_full_message_buffer[len++] = ':';
+  s_full_message_buffer[len] = '\0';
+  return len;
+}
 
-  /* Try to acquire mutex if RTOS is ready and mutex exists */
-  bool took_mutex = false;
-  took_mutex = elog_enter_cs();
-  memset(s_fmt, 0, sizeof(s_fmt));
-  memset(s_full_message_buffer, 0, sizeof(s_full_message_buffer));
-
-  /* Add location information with color support - ensure null termination */
-  #if ELOG_USE_COLOR
-  const char *colors[] = {
-      [ELOG_LEVEL_TRACE] = LOG_COLOR(LOG_COLOR_BLUE),    /* Blue for trace */
-      [ELOG_LEVEL_DEBUG] = LOG_COLOR(LOG_COLOR_CYAN),    /* Cyan for debug */
-      [ELOG_LEVEL_INFO] = LOG_COLOR(LOG_COLOR_GREEN),    /* Green for info */
-      [ELOG_LEVEL_WARNING] = LOG_COLOR(LOG_COLOR_BROWN), /* Brown/Yellow for warning */
-      [ELOG_LEVEL_ERROR] = LOG_COLOR(LOG_COLOR_RED),     /* Red for error */
-      [ELOG_LEVEL_CRITICAL] = LOG_BOLD(LOG_COLOR_RED),   /* Bold Red for critical */
-      [ELOG_LEVEL_ALWAYS] = LOG_BOLD("37")               /* Bold White for always */
-  };
-
-  const char *color_code = (level >= ELOG_LEVEL_TRACE && level <= ELOG_LEVEL_ALWAYS) ? colors[level] : "";
-  const char *end_color = (level >= ELOG_LEVEL_TRACE && level <= ELOG_LEVEL_ALWAYS) ? LOG_RESET_COLOR : "";
-
-  #else
-  const char *color_code = "";
-  const char *end_color = "";
-  #endif
+/**
+ * @brief Expand the user format once at the prefix offset and terminate the line
+ * @note  The body is truncated so that the color reset and newline always fit.
+ * @param prefix_len: Number of prefix characters already in the message buffer
+ * @param end_color: Color reset sequence ("" when colors are disabled)
+ * @param fmt: Printf-style format string
+ * @param args: Format arguments
+ * @param body_len: Receives the length of the expanded user message
+ * @return Length of the complete message, or -1 on formatting error
+ */
+static int elog_format_body(int prefix_len, const char *end_color, const char *fmt, va_list args, int *body_len)
+{
+  const size_t suffix_len = strlen(end_color) + 1; /* reset sequence + '\n' */
+  const size_t cap = sizeof(s_full_message_buffer) - suffix_len - 1;
+  size_t len = ((size_t)prefix_len > cap) ? cap : (size_t)prefix_len;
 
-  va_list args;
+  int n = ELOG_VSNPRINTF(s_full_message_buffer + len, cap - len + 1, fmt, args);
+  if (n < 0)
+  {
+    *body_len = 0;
+    return -1;
+  }
+  *body_len = ((size_t)n > cap - len) ? (int)(cap - len) : n;
+  len += (size_t)*body_len;
 
-  /* Format the user message first */
-  va_start(args, fmt);
-  snprintf(s_fmt, sizeof(s_fmt), 
-          "%s%s:%u,%lu:[%s][%s][%d] %s%s\n", 
-            color_code, elog_level_name(level),(uint8_t)module, 
-          get_runing_nbr(module), file, func, line, fmt, end_color);
+  memcpy(s_full_message_buffer + len, end_color, suffix_len - 1);
+  len += suffix_len - 1;
+  s_full_message_buffer[len++] = '\n';
+  s_full_message_buffer[len] = '\0';
+  return (int)len;
+}
 
-  int final_len = vsnprintf(s_full_message_buffer, sizeof(s_full_message_buffer), s_fmt, args);
-  va_end(args);
+/* Room kept for the "... N more bytes" line of a cut hexdump */
+#define ELOG_HEXDUMP_MORE_LEN 32u
 
+/**
+ * @brief Append the hex lines of an ELOG_HEXDUMP record after its header, keeping the line terminator
+ * @param len: Length of the complete message so far (ends with color reset and newline)
+ * @param end_color: Color reset sequence ("" when colors are disabled)
+ * @param data: Bytes to dump
+ * @param data_len: Number of bytes
+ * @param body_len: User message length, extended by the appended lines
+ * @return New length of the complete message
+ */
+static int elog_format_hexdump(int len, const char *end_color, const uint8_t *data, uint32_t data_len, int *body_len)
+{
+  const size_t suffix_len = strlen(end_color) + 1;
+  const size_t cap = sizeof(s_full_message_buffer) - suffix_len - 1;
+  const size_t offset_bytes = (data_len > 0x10000u) ? 4u : 2u;
+  const size_t start = (size_t)len - suffix_len;
+  size_t pos = start;
+  uint32_t off = 0;
 
+  while (off < data_len)
+  {
+    uint32_t n = data_len - off;
+    if (n > ELOG_HEXDUMP_BYTES_PER_LINE) { n = ELOG_HEXDUMP_BYTES_PER_LINE; }
+    size_t line_len = 1u + offset_bytes * 2u + 2u + (size_t)n * 3u - 1u;
+    size_t reserve = (off + n < data_len) ? ELOG_HEXDUMP_MORE_LEN : 0u;
+    if (pos + line_len + reserve > cap) { break; }
 
-  /* Send to all subscribers */
-  for (int i = 0; i < s_num_subscribers; i++)
+    /* "\n<offset>: XX XX ..." with the offset big-endian, hex-encoded like the data */
+    uint8_t be[4] = {(uint8_t)(off >> 24), (uint8_t)(off >> 16), (uint8_t)(off >> 8), (uint8_t)off};
+    s_full_message_buffer[pos++] = '\n';
+    pos += elog_hex_encode(s_full_message_buffer + pos, be + (4u - offset_bytes), offset_bytes, '\0');
+    s_full_message_buffer[pos++] = ':';
+    s_full_message_buffer[pos++] = ' ';
+    pos += elog_hex_encode(s_full_message_buffer + pos, data + off, n, ' ');
+    off += n;
+  }
+  if (off < data_len)
   {
-    if (level >= s_subscribers[i].threshold)
-    {
-      if(final_len > 0) { s_subscribers[i].fn(1, s_full_message_buffer, final_len); }
-      else { s_subscribers[i].fn(1, "vsnprintf error!!!", 19); }
-    }
+    int more = ELOG_SNPRINTF(s_full_message_buffer + pos, cap - pos + 1u, "\n... %" PRIu32 " more bytes",
+                             data_len - off);
+    if (more > 0) { pos += ((size_t)more > cap - pos) ? cap - pos : (size_t)more; }
   }
+  *body_len += (int)(pos - start);
 
-  /* Give mutex only if we took it */
-  elog_exit_cs(took_mutex);
+  memcpy(s_full_message_buffer + pos, end_color, suffix_len - 1);
+  pos += suffix_len - 1;
+  s_full_message_buffer[pos++] = '\n';
+  s_full_message_buffer[pos] = '\0';
+  return (int)pos;
 }
-#else
+
 /**
- * @brief Thread-safe version of log_message
- * @param level: Severity level of the message
- * @param fmt: Printf-style format string
- * @param ...: Format arguments
+ * @brief Append " key=value" for each field of an ELOG_KV record, keeping the line terminator
+ * @note  Fields that no longer fit the message buffer are left out.
+ * @param len: Length of the complete message so far (ends with color reset and newline)
+ * @param end_color: Color reset sequence ("" when colors are disabled)
+ * @param fields: Fields to render
+ * @param count: Number of fields
+ * @param body_len: User message length, extended by the appended fields
+ * @return New length of the complete message
  */
-void elog_message(elog_module_t module, elog_level_t level, const char *fmt, ...)
+static int elog_format_kv(int len, const char *end_color, const elog_kv_t *fields, uint32_t count, int *body_len)
 {
-  if (level < elog_get_module_threshold(module))
-  {
-    return; // Skip log if below module threshold
-  }
-  /* Try to acquire mutex if RTOS is ready and mutex exists */
-  bool took_mutex = false;
-  int fmt_len = 0;
-  int final_len = 0;
-  took_mutex = elog_enter_cs();
-  memset(s_fmt, 0, sizeof(s_fmt));
-  memset(s_full_message_buffer, 0, sizeof(s_full_message_buffer));
-  
-  #if ELOG_USE_COLOR
-  /* Color codes for different log levels */
-  const char *colors[] = {
-      [ELOG_LEVEL_TRACE] = LOG_COLOR(LOG_COLOR_BLUE),    /* Blue for trace */
-      [ELOG_LEVEL_INFO] = LOG_COLOR(LOG_COLOR_GREEN),    /* Green for info */
-      [ELOG_LEVEL_DEBUG] = LOG_COLOR(LOG_COLOR_CYAN),    /* Cyan for debug */
-      [ELOG_LEVEL_WARNING] = LOG_COLOR(LOG_COLOR_BROWN), /* Brown/Yellow for warning */
-      [ELOG_LEVEL_ERROR] = LOG_COLOR(LOG_COLOR_RED),     /* Red for error */
-      [ELOG_LEVEL_CRITICAL] = LOG_BOLD(LOG_COLOR_RED),   /* Bold Red for critical */
-      [ELOG_LEVEL_ALWAYS] = LOG_BOLD("37")               /* Bold White for always */
-  };
-  const char *color_code = (level >= ELOG_LEVEL_TRACE && level <= ELOG_LEVEL_ALWAYS) ? colors[level] : "";
-  const char *end_color = (level >= ELOG_LEVEL_TRACE && level <= ELOG_LEVEL_ALWAYS) ? LOG_RESET_COLOR : "";
-
-  #else
-  /* No color*/
-  const char *color_code = "";
-  const char *end_color = "";
-  #endif
-  va_list args;
-  /* Format the message */
-  va_start(args, fmt);
-  fmt_len = snprintf(s_fmt, sizeof(s_fmt), 
-                  "%s%s:%u,%lu: %s%s\n", 
-                    color_code, elog_level_name(level),(uint8_t)module, 
-                  get_runing_nbr(module), fmt, end_color);
-  final_len = vsnprintf(s_full_message_buffer, sizeof(s_full_message_buffer), s_fmt, args);
-  va_end(args); 
+  const size_t suffix_len = strlen(end_color) + 1;
+  const size_t cap = sizeof(s_full_message_buffer) - suffix_len - 1;
+  const size_t start = (size_t)len - suffix_len;
+  size_t pos = start;
 
-  /* Send to all subscribers */
-  for (int i = 0; i < s_num_subscribers; i++)
+  for (uint32_t i = 0; i < count; i++)
   {
-    if (level >= s_subscribers[i].threshold)
+    const elog_kv_t *f = &fields[i];
+    char num[24];
+    const char *value = num;
+    int value_len = 0;
+    switch (f->type)
     {
-      // printf("[DEBUG] Sending message to subscriber %d.\n", i);
-      if (final_len > 0) { s_subscribers[i].fn(1, s_full_message_buffer, final_len); }
-      else { s_subscribers[i].fn(1, "vsnprintf error!!!", 19); }
+    case ELOG_KV_U32: value_len = ELOG_SNPRINTF(num, sizeof(num), "%" PRIu32, f->v.u32); break;
+    case ELOG_KV_I32: value_len = ELOG_SNPRINTF(num, sizeof(num), "%" PRId32, f->v.i32); break;
+    case ELOG_KV_U64: value_len = ELOG_SNPRINTF(num, sizeof(num), "%" PRIu64, f->v.u64); break;
+    case ELOG_KV_I64: value_len = ELOG_SNPRINTF(num, sizeof(num), "%" PRId64, f->v.i64); break;
+    case ELOG_KV_X32: value_len = ELOG_SNPRINTF(num, sizeof(num), "0x%08" PRIX32, f->v.u32); break;
+    case ELOG_KV_F32: value_len = ELOG_SNPRINTF(num, sizeof(num), "%g", (double)f->v.f32); break;
+    case ELOG_KV_BOOL:
+      value = f->v.b ? "true" : "false";
+      value_len = f->v.b ? 4 : 5;
+      break;
+    case ELOG_KV_STR:
+      value = (f->v.str != NULL) ? f->v.str : "(null)";
+      value_len = (int)strlen(value);
+      break;
+    default:
+      value = "?";
+      value_len = 1;
+      break;
     }
+    if (value_len < 0) { continue; }
+    if (value_len >= (int)sizeof(num) && value == num) { value_len = (int)sizeof(num) - 1; }
+
+    /* Quote strings a key=value parser would otherwise split */
+    const bool quote = (f->type == ELOG_KV_STR) && (value_len == 0 || memchr(value, ' ', (size_t)value_len) != NULL);
+    const char *key = (f->key != NULL) ? f->key : "";
+    const size_t key_len = strlen(key);
+    const size_t need = 1u + key_len + 1u + (size_t)value_len + (quote ? 2u : 0u);
+    if (pos + need > cap) { break; }
+
+    s_full_message_buffer[pos++] = ' ';
+    memcpy(s_full_message_buffer + pos, key, key_len);
+    pos += key_len;
+    s_full_message_buffer[pos++] = '=';
+    if (quote) { s_full_message_buffer[pos++] = '"'; }
+    memcpy(s_full_message_buffer + pos, value, (size_t)value_len);
+    pos += (size_t)value_len;
+    if (quote) { s_full_message_buffer[pos++] = '"'; }
   }
+  *body_len += (int)(pos - start);
 
-  /* Give mutex only if we took it */
-  elog_exit_cs(took_mutex);
+  memcpy(s_full_message_buffer + pos, end_color, suffix_len - 1);
+  pos += suffix_len - 1;
+  s_full_message_buffer[pos++] = '\n';
+  s_full_message_buffer[pos] = '\0';
+  return (int)pos;
 }
-#endif
+
 /**
- * @brief Thread-safe version of log_subscribe
- * @param fn: Function to call for each log message
- * @param threshold: Minimum level to send to this subscriber
- * @return Error code
+ * @brief Expand a format given as variadic arguments (see elog_format_body)
  */
-elog_err_t elog_subscribe(log_subscriber_t fn, elog_level_t threshold)
+static int elog_format_body_args(int prefix_len, const char *end_color, int *body_len, const char *fmt, ...)
 {
-  /* Try to acquire mutex if RTOS is ready and mutex exists */
-  bool took_mutex = false;
-  took_mutex = elog_enter_cs();
+  va_list args;
+  va_start(args, fmt);
+  int len = elog_format_body(prefix_len, end_color, fmt, args, body_len);
+  va_end(args);
+  return len;
+}
+
+/**
+ * @brief Compose the text form of a record into the message buffer (once per record)
+ * @param rec: Record to format
+ */
+static void elog_record_format(elog_record_t *rec)
+{
+  const char *end_color = "";
+  int prefix_len = elog_format_prefix(rec, &end_color);
+  if (rec->file != NULL)
+  {
+    int loc_len = ELOG_SNPRINTF(s_full_message_buffer + prefix_len, sizeof(s_full_message_buffer) - prefix_len,
+                                "[%s][%s][%d] ", rec->file, rec->func, rec->line);
+    if (loc_len > 0) { prefix_len += loc_len; }
+  }
+  else
+  {
+    s_full_message_buffer[prefix_len++] = ' ';
+  }
+
+  if (rec->span != 0u)
+  {
+    /* ELOG_SPAN: fmt is the span name, printed verbatim */
+    uint32_t rate = ELOG_ATOMIC_LOAD(&s_ts_rate);
+    if (rec->span == ELOG_SPAN_PHASE_BEGIN || !rec->has_timestamp)
+    {
+      rec->text_len = elog_format_body_args(prefix_len, end_color, &rec->body_len, "%c %s",
+                                            (rec->span == ELOG_SPAN_PHASE_BEGIN) ? '>' : '<', rec->fmt);
+    }
+    else if (rate == 0u)
+    {
+      rec->text_len = elog_format_body_args(prefix_len, end_color, &rec->body_len, "< %s %" PRIu32 " ticks",
+                                            rec->fmt, rec->span_ticks);
+    }
+    else
+    {
+      uint32_t us = (uint32_t)(((uint64_t)rec->span_ticks * 1000000u) / rate);
+      rec->text_len = elog_format_body_args(prefix_len, end_color, &rec->body_len, "< %s %" PRIu32 " us",
+                                            rec->fmt, us);
+    }
+  }
+  else if (rec->fields != NULL)
+  {
+    /* ELOG_KV: fmt is the event name, printed verbatim */
+    rec->text_len = elog_format_body_args(prefix_len, end_color, &rec->body_len, "%s", rec->fmt);
+    if (rec->text_len >= 0)
+    {
+      rec->text_len = elog_format_kv(rec->text_len, end_color, rec->fields, rec->field_count, &rec->body_len);
+    }
+  }
+  else
+  {
+    va_list args;
+    va_copy(args, *rec->args);
+    rec->text_len = elog_format_body(prefix_len, end_color, rec->fmt, args, &rec->body_len);
+    va_end(args);
+  }
+  if (rec->data != NULL && rec->text_len >= 0)
+  {
+    rec->text_len = elog_format_hexdump(rec->text_len, end_color, rec->data, rec->data_len, &rec->body_len);
+  }
+  rec->body_offset = (rec->text_len < 0 || prefix_len < rec->text_len) ? prefix_len : 0;
+  s_stats.formatted++;
+}
+
+/**
+ * @brief Get the full text line of a record, formatting it on first use
+ * @param record: Record passed to a record subscriber
+ * @param len: Receives the text length (may be NULL)
+ * @return Text as delivered to text subscribers (valid during the callback)
+ */
+const char *elog_record_text(const elog_record_t *record, size_t *len)
+{
+  elog_record_t *rec = (elog_record_t *)record; /* records are owned by eLog; only the text cache changes */
+  if (rec->text_len == ELOG_TEXT_PENDING) { elog_record_format(rec); }
+  if (rec->text_len < 0)
+  {
+    if (len != NULL) { *len = 19; }
+    return "vsnprintf error!!!";
+  }
+  if (len != NULL) { *len = (size_t)rec->text_len; }
+  return s_full_message_buffer;
+}
+
+/**
+ * @brief Get only the user message of a record (no prefix, color or newline), formatting it on first use
+ * @param record: Record passed to a record subscriber
+ * @param len: Receives the message length (may be NULL)
+ * @return Message text, not NUL-terminated at len (valid during the callback)
+ */
+const char *elog_record_message(const elog_record_t *record, size_t *len)
+{
+  const char *text = elog_record_text(record, NULL);
+  if (record->text_len < 0)
+  {
+    if (len != NULL) { *len = 18; }
+    return text;
+  }
+  if (len != NULL) { *len = (size_t)record->body_len; }
+  return text + record->body_offset;
+}
+
+/* ========================================================================== */
+/* Subscriber Backpressure */
+/* ========================================================================== */
+
+static char s_bp_line[ELOG_FULL_MESSAGE_LENGTH]; /* Backlog line being retried (under s_log_mutex) */
+
+/**
+ * @brief Copy bytes into / out of a backlog at a wrapping offset
+ */
+static void elog_bp_copy_in(elog_backpressure_t *bp, uint32_t pos, const void *src, uint32_t n)
+{
+  uint32_t first = bp->cfg.backlog_size - pos;
+  if (first > n) { first = n; }
+  memcpy(bp->cfg.backlog + pos, src, first);
+  memcpy(bp->cfg.backlog, (const uint8_t *)src + first, n - first);
+}
+
+static void elog_bp_copy_out(const elog_backpressure_t *bp, uint32_t pos, void *dst, uint32_t n)
+{
+  uint32_t first = bp->cfg.backlog_size - pos;
+  if (first > n) { first = n; }
+  memcpy(dst, bp->cfg.backlog + pos, first);
+  memcpy((uint8_t *)dst + first, bp->cfg.backlog, n - first);
+}
+
+/**
+ * @brief Length of the oldest backlog line
+ */
+static uint32_t elog_bp_front_len(const elog_backpressure_t *bp)
+{
+  uint8_t hdr[2];
+  elog_bp_copy_out(bp, bp->head, hdr, 2u);
+  return (uint32_t)hdr[0] | ((uint32_t)hdr[1] << 8);
+}
+
+/**
+ * @brief Remove the oldest backlog line
+ */
+static void elog_bp_pop(elog_backpressure_t *bp)
+{
+  uint32_t n = 2u + elog_bp_front_len(bp);
+  bp->head = (bp->head + n) % bp->cfg.backlog_size;
+  bp->used -= n;
+}
+
+/**
+ * @brief Park a refused line, evicting the oldest lines until it fits
+ */
+static void elog_bp_park(elog_backpressure_t *bp, const char *text, size_t len)
+{
+  uint32_t need = 2u + (uint32_t)len;
+  if (need > bp->cfg.backlog_size)
+  {
+    bp->stats.dropped_newest++;
+    return;
+  }
+  while (bp->cfg.backlog_size - bp->used < need)
+  {
+    elog_bp_pop(bp);
+    bp->stats.dropped_oldest++;
+  }
+  const uint8_t hdr[2] = {(uint8_t)(len & 0xFFu), (uint8_t)(len >> 8)};
+  uint32_t tail = (bp->head + bp->used) % bp->cfg.backlog_size;
+  elog_bp_copy_in(bp, tail, hdr, 2u);
+  elog_bp_copy_in(bp, (tail + 2u) % bp->cfg.backlog_size, text, (uint32_t)len);
+  bp->used += need;
+  if (bp->used > bp->stats.backlog_max) { bp->stats.backlog_max = bp->used; }
+}
+
+/**
+ * @brief Hand backlog lines to the subscriber, oldest first (caller holds s_log_mutex)
+ * @return true once the backlog is empty, false if the subscriber is still busy
+ */
+static bool elog_bp_retry(elog_backpressure_t *bp, uint32_t *delivered)
+{
+  while (bp->used != 0u)
+  {
+    uint32_t n = elog_bp_front_len(bp);
+    elog_bp_copy_out(bp, (bp->head + 2u) % bp->cfg.backlog_size, s_bp_line, n);
+    if (bp->fn(1, s_bp_line, n) < 0)
+    {
+      bp->stats.busy++;
+      s_stats.sink_busy++;
+      return false;
+    }
+    elog_bp_pop(bp);
+    bp->stats.delivered++;
+    (*delivered)++;
+  }
+  return true;
+}
+
+/**
+ * @brief Deliver a line to a subscriber with a backpressure policy (caller holds s_log_mutex)
+ */
+static void elog_bp_deliver(elog_backpressure_t *bp, const char *text, size_t len)
+{
+  uint32_t retried = 0;
+  /* Parked lines go first so the subscriber sees lines in order */
+  if (bp->used == 0u || elog_bp_retry(bp, &retried))
+  {
+    if (bp->fn(1, text, len) >= 0)
+    {
+      bp->stats.delivered++;
+      return;
+    }
+    bp->stats.busy++;
+    s_stats.sink_busy++;
+  }
+
+  switch (bp->cfg.policy)
+  {
+  case ELOG_BP_DROP_OLDEST:
+    elog_bp_park(bp, text, len);
+    break;
+  case ELOG_BP_BLOCK:
+    bp->stats.waits++;
+    for (uint32_t waited = 0; waited < bp->cfg.timeout_ms; waited++)
+    {
+      bp->cfg.wait_ms(1u);
+      if (bp->fn(1, text, len) >= 0)
+      {
+        bp->stats.delivered++;
+        return;
+      }
+    }
+    bp->stats.timeouts++;
+    bp->stats.dropped_newest++;
+    break;
+  case ELOG_BP_SPILL:
+    if (bp->cfg.spill(1, text, len) >= 0) { bp->stats.spilled++; }
+    else { bp->stats.dropped_newest++; }
+    break;
+  default:
+    bp->stats.dropped_newest++;
+    break;
+  }
+}
+
+/**
+ * @brief Deliver a record to every subscriber accepting (module, level)
+ * @note  Text is composed only if a text subscriber (or a record subscriber asking for it) needs it.
+ * @param rec: Record to deliver
+ */
+static void elog_dispatch(elog_record_t *rec)
+{
+  subscriber_snapshot_t snap;
+  elog_subs_snapshot(&snap, rec->module, rec->level);
+  if (snap.mask == 0)
+  {
+    /* Subscribers changed between the early check and dispatch */
+    s_stats.undelivered++;
+    return;
+  }
+  for (int i = 0; snap.mask != 0; i++, snap.mask >>= 1)
+  {
+    if (!(snap.mask & 1u)) { continue; }
+    if (snap.entries[i].record_fn != NULL)
+    {
+      snap.entries[i].record_fn(rec);
+    }
+    else
+    {
+      size_t len;
+      const char *text = elog_record_text(rec, &len);
+      if (snap.entries[i].bp != NULL)
+      {
+        elog_bp_deliver(snap.entries[i].bp, text, len);
+      }
+      else if (snap.entries[i].fn(1, text, len) < 0)
+      {
+        s_stats.sink_busy++;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Build a record and send it to all subscribers (caller holds s_log_mutex)
+ * @note  Sequence numbers are allocated here, so records folded by coalescing leave no gaps.
+ */
+static void elog_deliver(elog_module_t module, elog_level_t level, const char *file, const char *func, int line,
+                         const elog_attach_t *attach, uint16_t sample_rate, bool has_timestamp, uint32_t timestamp,
+                         const char *fmt, va_list args)
+{
+  va_list record_args;
+  va_copy(record_args, args);
+  elog_record_t rec = {
+      .module = module,
+      .level = level,
+      .sequence = get_runing_nbr(module),
+      .global_sequence = elog_seq_next(&s_log_global_number),
+      .timestamp = timestamp,
+      .has_timestamp = has_timestamp,
+      .fmt = fmt,
+      .args = &record_args,
+      .file = file,
+      .func = func,
+      .line = line,
+      .sample_rate = sample_rate,
+      .text_len = ELOG_TEXT_PENDING,
+  };
+  if (attach != NULL)
+  {
+    rec.data = attach->data;
+    rec.data_len = attach->data_len;
+    rec.fields = attach->fields;
+    rec.field_count = attach->field_count;
+    rec.span = attach->span;
+    rec.span_ticks = (attach->span == ELOG_SPAN_PHASE_END) ? timestamp - attach->span_start : 0u;
+  }
+
+  /* Send to all subscribers of a stable snapshot (no lock shared with subscribe/unsubscribe) */
+  elog_dispatch(&rec);
+  va_end(record_args);
+}
+
+#if (ELOG_COALESCE_ENABLE == YES)
+/**
+ * @brief Emit an eLog-generated record while already holding s_log_mutex
+ */
+static void elog_emit_locked(elog_module_t module, elog_level_t level, uint32_t timestamp, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  elog_deliver(module, level, NULL, NULL, 0, NULL, 1u, true, timestamp, fmt, args);
+  va_end(args);
+}
+
+/**
+ * @brief Emit the pending "repeated N times" summary of a slot
+ */
+static void elog_coalesce_report(coalesce_slot_t *slot, uint32_t timestamp)
+{
+  if (slot->repeats != 0u)
+  {
+    uint32_t n = slot->repeats;
+    slot->repeats = 0;
+    elog_emit_locked((elog_module_t)slot->module, (elog_level_t)slot->level, timestamp,
+                     "repeated %" PRIu32 " times: %s", n, slot->fmt);
+  }
+}
+
+/**
+ * @brief Fold a record into a recent identical one (same fmt pointer and argument values)
+ * @note  Caller holds s_log_mutex.
+ * @return true if the record was absorbed and must not be delivered
+ */
+static bool elog_coalesce(elog_module_t module, elog_level_t level, const char *fmt, va_list args, uint32_t now)
+{
+  const uint32_t window = (uint32_t)(((uint64_t)s_ts_rate * ELOG_COALESCE_WINDOW_MS) / 1000u);
+  const uint32_t hash = elog_fmt_hash_args(fmt, args);
+
+  coalesce_slot_t *same_fmt = NULL;
+  for (int i = 0; i < ELOG_COALESCE_SLOTS; i++)
+  {
+    coalesce_slot_t *slot = &s_coalesce[i];
+    if (slot->fmt != fmt || slot->module != (uint8_t)module || slot->level != (uint8_t)level)
+    {
+      continue;
+    }
+    same_fmt = slot;
+    if (slot->hash == hash)
+    {
+      if (now - slot->first_ts < window)
+      {
+        slot->repeats++;
+        s_stats.coalesced++;
+        return true;
+      }
+      /* Window over: report the run and start a new one with this record */
+      elog_coalesce_report(slot, now);
+      slot->first_ts = now;
+      return false;
+    }
+  }
+
+  /* New message: the same statement with new values ends its previous run, otherwise recycle the oldest slot */
+  coalesce_slot_t *slot = same_fmt;
+  if (slot == NULL)
+  {
+    slot = &s_coalesce[s_coalesce_next];
+    s_coalesce_next = (uint8_t)((s_coalesce_next + 1u) % ELOG_COALESCE_SLOTS);
+  }
+  elog_coalesce_report(slot, now);
+  slot->fmt = fmt;
+  slot->hash = hash;
+  slot->first_ts = now;
+  slot->module = (uint8_t)module;
+  slot->level = (uint8_t)level;
+  return false;
+}
+#endif
+
+#if (ELOG_SAMPLING_ENABLE == YES)
+/**
+ * @brief Decide whether a record of a sampled module is kept (lock-free, callable from any context)
+ * @param module: Module identifier (in range)
+ * @param rate: Receives the module's sampling rate
+ * @return true if the record is kept
+ */
+static bool elog_sample_pass(elog_module_t module, uint16_t *rate)
+{
+  uint32_t config = __atomic_load_n(&s_sample_config[module], __ATOMIC_RELAXED);
+  uint16_t n = (uint16_t)config;
+  if (n <= 1u) { return true; }
+  *rate = n;
+
+  if ((elog_sample_mode_t)(config >> 16) == ELOG_SAMPLE_RANDOM)
+  {
+    /* xorshift32; concurrent callers may reuse a state, which only repeats a draw */
+    uint32_t x = __atomic_load_n(&s_sample_rng, __ATOMIC_RELAXED);
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    __atomic_store_n(&s_sample_rng, x, __ATOMIC_RELAXED);
+    return x < UINT32_MAX / n;
+  }
+  return (__atomic_fetch_add(&s_sample_count[module], 1u, __ATOMIC_RELAXED) % n) == 0u;
+}
+#endif
+
+#if (ELOG_ISR_ENABLE == YES)
+/**
+ * @brief Claim the next free queue position
+ * @return Slot owned by the caller, or NULL if the queue is full
+ */
+static elog_isr_slot_t *elog_isr_claim(void)
+{
+#if defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_8M_BASE__)
+  /* No exclusives: a few instructions with interrupts masked */
+  elog_isr_slot_t *slot = NULL;
+  uint32_t primask;
+  __asm volatile("mrs %0, primask\n cpsid i" : "=r"(primask) : : "memory");
+  uint32_t pos = s_isr_head;
+  if (s_isr_queue[pos & (ELOG_ISR_QUEUE_LEN - 1u)].turn == pos)
+  {
+    slot = &s_isr_queue[pos & (ELOG_ISR_QUEUE_LEN - 1u)];
+    s_isr_head = pos + 1u;
+  }
+  __asm volatile("msr primask, %0" : : "r"(primask) : "memory");
+  return slot;
+#else
+  uint32_t pos = __atomic_load_n(&s_isr_head, __ATOMIC_RELAXED);
+  for (;;)
+  {
+    elog_isr_slot_t *slot = &s_isr_queue[pos & (ELOG_ISR_QUEUE_LEN - 1u)];
+    uint32_t turn = __atomic_load_n(&slot->turn, __ATOMIC_ACQUIRE);
+    if (turn != pos)
+    {
+      if ((int32_t)(turn - pos) < 0) { return NULL; } /* Slot of the previous lap not drained yet */
+      pos = __atomic_load_n(&s_isr_head, __ATOMIC_RELAXED); /* Another producer took pos */
+      continue;
+    }
+    if (__atomic_compare_exchange_n(&s_isr_head, &pos, pos + 1u, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+      return slot;
+    }
+  }
+#endif
+}
+
+/**
+ * @brief Capture a record in interrupt context: no mutex, no formatting, bounded work
+ */
+static void elog_isr_capture(elog_module_t module, elog_level_t level, const char *file, const char *func, int line,
+                             const elog_attach_t *attach, uint16_t sample_rate, const char *fmt, va_list args)
+{
+  elog_isr_slot_t *slot = (attach == NULL) ? elog_isr_claim() : NULL; /* attachments live on the caller's stack */
+  if (slot == NULL)
+  {
+    ELOG_ATOMIC_INC(&s_isr_dropped);
+    ELOG_ATOMIC_INC(&s_stats.isr_dropped);
+    return;
+  }
+
+  elog_timestamp_fn_t ts_source = ELOG_ATOMIC_LOAD(&s_ts_source);
+  size_t nargs = elog_fmt_pack_args(fmt, args, slot->args, ELOG_ISR_MAX_ARGS);
+  slot->timestamp = (ts_source != NULL) ? ts_source() : 0u;
+  slot->has_timestamp = (ts_source != NULL) ? 1u : 0u;
+  slot->file = file;
+  slot->func = func;
+  slot->line = line;
+  slot->module = (uint8_t)module;
+  slot->level = (uint8_t)level;
+  slot->sample_rate = sample_rate;
+  if (nargs > ELOG_ISR_MAX_ARGS)
+  {
+    /* Still publish the slot (positions are claimed in order); the drain reports it as lost */
+    slot->fmt = NULL;
+    nargs = 0;
+  }
+  else
+  {
+    slot->fmt = fmt;
+    ELOG_ATOMIC_INC(&s_stats.isr_deferred);
+  }
+  slot->nargs = (uint8_t)nargs;
+  __atomic_store_n(&slot->turn, __atomic_load_n(&slot->turn, __ATOMIC_RELAXED) + 1u, __ATOMIC_RELEASE);
+}
+#endif
+
+/**
+ * @brief Common path of elog_message / elog_message_with_location / elog_hexdump / elog_kv
+ * @param attach: Hexdump buffer or KV fields carried by the record, or NULL
+ */
+static void elog_vmessage(elog_module_t module, elog_level_t level, const char *file, const char *func, int line,
+                          const elog_attach_t *attach, const char *fmt, va_list args)
+{
+  if (!ELOG_LEVEL_ENABLED(module, level))
+  {
+    return; // Skip log if below module threshold (direct callers bypass the macro check)
+  }
+  if (elog_subs_wanted(module, level) == 0)
+  {
+    ELOG_ATOMIC_INC(&s_stats.rejected_early);
+    return; // No subscriber accepts this (module, level): skip formatting entirely
+  }
+  uint16_t sample_rate = 1u;
+#if (ELOG_SAMPLING_ENABLE == YES)
+  if ((unsigned)level <= (unsigned)ELOG_SAMPLING_MAX_LEVEL && (unsigned)module < (unsigned)ELOG_MD_MAX &&
+      (attach == NULL || attach->span == 0u) && !elog_sample_pass(module, &sample_rate))
+  {
+    ELOG_ATOMIC_INC(&s_stats.sampled_out);
+    return; // Sampled out: not timestamped, not formatted
+  }
+#endif
+#if (ELOG_ISR_ENABLE == YES)
+  if (ELOG_IN_ISR())
+  {
+    elog_isr_capture(module, level, file, func, line, attach, sample_rate, fmt, args);
+    return; // Deferred: elog_isr_drain() formats and delivers it from a task
+  }
+#endif
+
+  /* Sample the clock before waiting for the mutex so contention does not skew latencies */
+  elog_timestamp_fn_t ts_source = ELOG_ATOMIC_LOAD(&s_ts_source);
+  uint32_t timestamp = (ts_source != NULL) ? ts_source() : 0u;
+
+  /* Try to acquire mutex if RTOS is ready and mutex exists */
+  bool took_mutex = elog_enter_cs(&s_log_mutex);
+
+#if (ELOG_COALESCE_ENABLE == YES)
+  if (ts_source != NULL && attach == NULL && elog_coalesce(module, level, fmt, args, timestamp))
+  {
+    elog_exit_cs(&s_log_mutex, took_mutex);
+    return; // Folded into the pending "repeated N times" summary
+  }
+#endif
+
+  elog_deliver(module, level, file, func, line, attach, sample_rate, ts_source != NULL, timestamp, fmt, args);
+
+  /* Give mutex only if we took it */
+  elog_exit_cs(&s_log_mutex, took_mutex);
+}
+
+/**
+ * @brief Log a message generated by eLog itself (no call site, no location)
+ */
+static void elog_emit(elog_module_t module, elog_level_t level, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  elog_vmessage(module, level, NULL, NULL, 0, NULL, fmt, args);
+  va_end(args);
+}
+
+/* ========================================================================== */
+/* ISR Fast Path: Deferred Formatting */
+/* ========================================================================== */
+
+#if (ELOG_ISR_ENABLE == YES)
+/**
+ * @brief Format one conversion (rebuilt without '*') with the value type its length modifier names
+ */
+static int elog_isr_put(char *out, size_t room, const char *conv, char type, const char *lenmod, elog_arg_t v)
+{
+  const bool ll = (lenmod[0] == 'l' && lenmod[1] == 'l');
+  switch (type)
+  {
+  case 'd':
+  case 'i':
+    if (ll) { return ELOG_SNPRINTF(out, room, conv, (long long)v.i); }
+    if (lenmod[0] == 'l') { return ELOG_SNPRINTF(out, room, conv, (long)v.i); }
+    if (lenmod[0] == 'j') { return ELOG_SNPRINTF(out, room, conv, (intmax_t)v.i); }
+    if (lenmod[0] == 'z' || lenmod[0] == 't') { return ELOG_SNPRINTF(out, room, conv, (ptrdiff_t)v.i); }
+    return ELOG_SNPRINTF(out, room, conv, (int)v.i);
+  case 'u':
+  case 'x':
+  case 'X':
+  case 'o':
+    if (ll) { return ELOG_SNPRINTF(out, room, conv, (unsigned long long)v.u); }
+    if (lenmod[0] == 'l') { return ELOG_SNPRINTF(out, room, conv, (unsigned long)v.u); }
+    if (lenmod[0] == 'j') { return ELOG_SNPRINTF(out, room, conv, (uintmax_t)v.u); }
+    if (lenmod[0] == 'z' || lenmod[0] == 't') { return ELOG_SNPRINTF(out, room, conv, (size_t)v.u); }
+    return ELOG_SNPRINTF(out, room, conv, (unsigned int)v.u);
+  case 'c': return ELOG_SNPRINTF(out, room, conv, (int)v.i);
+  case 's': return ELOG_SNPRINTF(out, room, conv, (v.p != NULL) ? (const char *)v.p : "(null)");
+  case 'p': return ELOG_SNPRINTF(out, room, conv, v.p);
+  default: return ELOG_SNPRINTF(out, room, conv, v.f);
+  }
+}
+
+/**
+ * @brief Expand a format from values captured by elog_fmt_pack_args()
+ * @return Length written to buf (truncated to size - 1)
+ */
+static size_t elog_isr_render(char *buf, size_t size, const char *fmt, const elog_arg_t *args, size_t nargs)
+{
+  size_t len = 0;
+  size_t n = 0;
+  const char *f = fmt;
+  while (*f != '\0' && len + 1u < size)
+  {
+    if (*f != '%')
+    {
+      buf[len++] = *f++;
+      continue;
+    }
+    if (f[1] == '%')
+    {
+      buf[len++] = '%';
+      f += 2;
+      continue;
+    }
+
+    /* Copy flags, width, precision and length; substitute captured '*' values */
+    char conv[40];
+    size_t c = 0;
+    const char *lenmod = "";
+    conv[c++] = *f++;
+    while (*f != '\0' && strchr("-+ #0123456789.*hlLzjt", *f) != NULL && c < sizeof(conv) - 16u)
+    {
+      if (*f == '*')
+      {
+        int v = (n < nargs) ? (int)args[n++].i : 0;
+        if (f[-1] == '.' && v < 0) { c--; } /* Negative precision: as if omitted */
+        else { c += (size_t)ELOG_SNPRINTF(conv + c, sizeof(conv) - c, "%d", v); }
+      }
+      else
+      {
+        if (*lenmod == '\0' && strchr("hlLzjt", *f) != NULL) { lenmod = f; }
+        conv[c++] = *f;
+      }
+      f++;
+    }
+    if (*f == '\0') { break; }
+    const char type = *f++;
+    conv[c++] = type;
+    conv[c] = '\0';
+
+    if (*lenmod == 'L')
+    {
+      /* long double was not captured (elog_fmt_pack_args stops there): the rest is emitted verbatim */
+      for (size_t k = 0; k < c && len + 1u < size; k++) { buf[len++] = conv[k]; }
+      while (*f != '\0' && len + 1u < size) { buf[len++] = *f++; }
+      break;
+    }
+
+    if (strchr("diuxXocspfFeEgG", type) == NULL)
+    {
+      /* Unsupported conversion: emit verbatim, consumes nothing */
+      for (size_t k = 0; k < c && len + 1u < size; k++) { buf[len++] = conv[k]; }
+      continue;
+    }
+    elog_arg_t v = (n < nargs) ? args[n++] : (elog_arg_t){.u = 0};
+    int w = elog_isr_put(buf + len, size - len, conv, type, lenmod, v);
+    if (w > 0) { len += ((size_t)w < size - len) ? (size_t)w : size - len - 1u; }
+  }
+  buf[len] = '\0';
+  return len;
+}
+
+/**
+ * @brief Deliver an expanded ISR record (caller holds s_log_mutex)
+ */
+static void elog_isr_deliver(const elog_isr_slot_t *slot, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  elog_deliver((elog_module_t)slot->module, (elog_level_t)slot->level, slot->file, slot->func, slot->line, NULL,
+               slot->sample_rate, slot->has_timestamp != 0u, slot->timestamp, fmt, args);
+  va_end(args);
+}
+#endif
+
+/**
+ * @brief Format and deliver records captured in interrupt context
+ * @param max_records: Upper bound on records delivered by this call, 0 for all pending
+ * @return Number of records delivered
+ */
+uint32_t elog_isr_drain(uint32_t max_records)
+{
+#if (ELOG_ISR_ENABLE == YES)
+  uint32_t delivered = 0;
+  bool took_mutex = elog_enter_cs(&s_log_mutex);
+
+  while (max_records == 0u || delivered < max_records)
+  {
+    elog_isr_slot_t *slot = &s_isr_queue[s_isr_tail & (ELOG_ISR_QUEUE_LEN - 1u)];
+    if (__atomic_load_n(&slot->turn, __ATOMIC_ACQUIRE) != s_isr_tail + 1u) { break; }
+
+    if (slot->fmt != NULL)
+    {
+      elog_isr_render(s_isr_message, sizeof(s_isr_message), slot->fmt, slot->args, slot->nargs);
+      elog_isr_deliver(slot, "%s", s_isr_message);
+      delivered++;
+    }
+    else
+    {
+      ELOG_ATOMIC_INC(&s_isr_dropped);
+      ELOG_ATOMIC_INC(&s_stats.isr_dropped);
+    }
+    /* Hand the slot to the producer one lap ahead */
+    __atomic_store_n(&slot->turn, s_isr_tail + ELOG_ISR_QUEUE_LEN, __ATOMIC_RELEASE);
+    s_isr_tail++;
+  }
+  elog_exit_cs(&s_log_mutex, took_mutex);
+
+  uint32_t lost = __atomic_exchange_n(&s_isr_dropped, 0u, __ATOMIC_RELAXED);
+  if (lost != 0u)
+  {
+    elog_emit((elog_module_t)0, ELOG_LEVEL_WARNING, "%" PRIu32 " ISR log records dropped", lost);
+  }
+  return delivered;
+#else
+  (void)max_records;
+  return 0;
+#endif
+}
+
+/**
+ * @brief Number of captured records waiting for elog_isr_drain()
+ */
+uint32_t elog_isr_pending(void)
+{
+#if (ELOG_ISR_ENABLE == YES)
+  return __atomic_load_n(&s_isr_head, __ATOMIC_RELAXED) - __atomic_load_n(&s_isr_tail, __ATOMIC_RELAXED);
+#else
+  return 0;
+#endif
+}
+
+/* ========================================================================== */
+/* Thread Safety Implementation */
+/* ========================================================================== */
+
+#if ENABLE_DEBUG_MESSAGES_WITH_LOCATION
+/**
+ * @brief Thread-safe version of log_message_with_location
+ * @param level: Severity level of the message
+ * @param file: Source file name
+ * @param func: Function name
+ * @param line: Line number
+ * @param fmt: Printf-style format string
+ * @param ...: Format arguments
+ */
+void elog_message_with_location(elog_module_t module, elog_level_t level, const char *file, const char *func,
+                                     int line, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  elog_vmessage(module, level, file, func, line, NULL, fmt, args);
+  va_end(args);
+}
+#else
+/**
+ * @brief Thread-safe version of log_message
+ * @param level: Severity level of the message
+ * @param fmt: Printf-style format string
+ * @param ...: Format arguments
+ */
+void elog_message(elog_module_t module, elog_level_t level, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  elog_vmessage(module, level, NULL, NULL, 0, NULL, fmt, args);
+  va_end(args);
+}
+#endif
+
+/* ========================================================================== */
+/* Buffer and Structured Logging */
+/* ========================================================================== */
+
+/**
+ * @brief Log a record whose content travels in the attachment rather than in the arguments
+ */
+static void elog_attach_message(elog_module_t module, elog_level_t level, const elog_attach_t *attach,
+                                const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  elog_vmessage(module, level, NULL, NULL, 0, attach, fmt, args);
+  va_end(args);
+}
+
+/**
+ * @brief Log a buffer as a single record (hex lines for text sinks, raw payload for binary sinks)
+ * @param module: Module identifier
+ * @param level: Severity level
+ * @param data: Buffer to dump
+ * @param len: Number of bytes
+ */
+void elog_hexdump(elog_module_t module, elog_level_t level, const void *data, size_t len)
+{
+  if (data == NULL)
+  {
+    return;
+  }
+  const elog_attach_t attach = {
+      .data = (const uint8_t *)data,
+      .data_len = (len > UINT32_MAX) ? UINT32_MAX : (uint32_t)len,
+  };
+  elog_attach_message(module, level, &attach, "hexdump %" PRIu32 " bytes:", attach.data_len);
+}
+
+/**
+ * @brief Log an event with typed fields (key=value text for text sinks, varints for binary sinks)
+ * @param module: Module identifier
+ * @param level: Severity level
+ * @param event: Event name (not a format string)
+ * @param fields: Field array
+ * @param count: Number of fields
+ */
+void elog_kv(elog_module_t module, elog_level_t level, const char *event, const elog_kv_t *fields, size_t count)
+{
+  if (event == NULL || fields == NULL)
+  {
+    return;
+  }
+  const elog_attach_t attach = {
+      .fields = fields,
+      .field_count = (count > UINT32_MAX) ? UINT32_MAX : (uint32_t)count,
+  };
+  elog_attach_message(module, level, &attach, event);
+}
 
-  elog_err_t result = ELOG_ERR_SUBSCRIBERS_EXCEEDED;
+/**
+ * @brief Log a span begin event and remember its start time
+ * @param span: Span state, passed to elog_span_end()
+ * @param module: Module identifier
+ * @param name: Span name (static string, printed verbatim)
+ */
+void elog_span_begin(elog_span_t *span, elog_module_t module, const char *name)
+{
+  if (span == NULL)
+  {
+    return;
+  }
+  span->name = name;
+  span->module = module;
+  span->active = (name != NULL) && ELOG_LEVEL_ENABLED(module, ELOG_SPAN_LEVEL);
+  if (!span->active)
+  {
+    return;
+  }
+  elog_timestamp_fn_t ts_source = ELOG_ATOMIC_LOAD(&s_ts_source);
+  span->start = (ts_source != NULL) ? ts_source() : 0u;
+  const elog_attach_t attach = {.span = ELOG_SPAN_PHASE_BEGIN};
+  elog_attach_message(module, ELOG_SPAN_LEVEL, &attach, name);
+}
+
+/**
+ * @brief Log the end event of a span whose begin was logged (cleanup handler of ELOG_SPAN_SCOPE)
+ * @param span: Span state from elog_span_begin()
+ */
+void elog_span_end(elog_span_t *span)
+{
+  if (span == NULL || !span->active)
+  {
+    return;
+  }
+  span->active = false;
+  const elog_attach_t attach = {.span = ELOG_SPAN_PHASE_END, .span_start = span->start};
+  elog_attach_message(span->module, ELOG_SPAN_LEVEL, &attach, span->name);
+}
+
+/* ========================================================================== */
+/* Per-Call-Site Rate Limiting */
+/* ========================================================================== */
+
+/* Call sites that have suppressed at least once (lock-free push-only list) */
+static elog_ratelimit_t *volatile s_rl_sites;
+
+/**
+ * @brief Emit a "N messages suppressed" summary for a call site
+ */
+static void elog_ratelimit_summary(elog_ratelimit_t *site, elog_module_t module, elog_level_t level)
+{
+  uint32_t n = __atomic_exchange_n(&site->suppressed, 0u, __ATOMIC_RELAXED);
+  if (n != 0u)
+  {
+    elog_emit(module, level, "%" PRIu32 " messages suppressed (line %u)", n, (unsigned)site->line);
+  }
+}
+
+/**
+ * @brief Take a token from a call site's bucket
+ * @note  Sites are not locked: concurrent callers of one site may over- or under-count by a token.
+ * @param site: Call-site state
+ * @param module: Module of the statement
+ * @param level: Level of the statement
+ * @return true if the record may be logged
+ */
+bool elog_ratelimit_pass(elog_ratelimit_t *site, elog_module_t module, elog_level_t level)
+{
+  elog_timestamp_fn_t ts_source = ELOG_ATOMIC_LOAD(&s_ts_source);
+  uint32_t rate = ELOG_ATOMIC_LOAD(&s_ts_rate);
+  if (ts_source == NULL || rate == 0u)
+  {
+    return true; // No time base: cannot refill, so do not limit
+  }
+
+  uint32_t now = ts_source();
+  if (!site->primed)
+  {
+    site->tokens = ELOG_RATELIMIT_BURST;
+    site->last_refill = now;
+    site->primed = true;
+  }
+  else
+  {
+    uint32_t period = rate / ELOG_RATELIMIT_PER_SEC;
+    uint32_t earned = (now - site->last_refill) / (period ? period : 1u);
+    if (earned != 0u)
+    {
+      uint32_t tokens = site->tokens + ((earned < ELOG_RATELIMIT_BURST) ? earned : ELOG_RATELIMIT_BURST);
+      site->tokens = (uint16_t)((tokens < ELOG_RATELIMIT_BURST) ? tokens : ELOG_RATELIMIT_BURST);
+      site->last_refill = (site->tokens == ELOG_RATELIMIT_BURST) ? now : site->last_refill + earned * period;
+    }
+  }
 
-  if (s_num_subscribers < ELOG_MAX_SUBSCRIBERS)
+  if (site->tokens == 0u)
   {
-    /* Check if already subscribed */
-    for (int i = 0; i < s_num_subscribers; i++)
+    ELOG_ATOMIC_INC(&site->suppressed);
+    ELOG_ATOMIC_INC(&s_stats.suppressed);
+    if (!__atomic_exchange_n(&site->registered, true, __ATOMIC_ACQ_REL))
     {
-      if (s_subscribers[i].fn == fn)
+      /* First suppression at this site: make it visible to elog_ratelimit_flush() */
+      site->module = (uint8_t)module;
+      site->level = (uint8_t)level;
+      elog_ratelimit_t *head = ELOG_ATOMIC_LOAD(&s_rl_sites);
+      do
       {
-        /* Update existing subscription */
-        s_subscribers[i].threshold = threshold;
-        result = ELOG_ERR_NONE;
-        goto exit;
-      }
+        site->next = head;
+      } while (!__atomic_compare_exchange_n(&s_rl_sites, &head, site, true, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+    }
+    return false;
+  }
+
+  site->tokens--;
+  elog_ratelimit_summary(site, module, level);
+  return true;
+}
+
+/**
+ * @brief Emit summaries for every call site with suppressed records (e.g. from an idle task)
+ */
+void elog_ratelimit_flush(void)
+{
+  for (elog_ratelimit_t *site = ELOG_ATOMIC_LOAD(&s_rl_sites); site != NULL; site = site->next)
+  {
+    elog_ratelimit_summary(site, (elog_module_t)site->module, (elog_level_t)site->level);
+  }
+}
+
+/**
+ * @brief Emit pending "repeated N times" summaries (e.g. from an idle task)
+ */
+void elog_coalesce_flush(void)
+{
+#if (ELOG_COALESCE_ENABLE == YES)
+  elog_timestamp_fn_t ts_source = ELOG_ATOMIC_LOAD(&s_ts_source);
+  uint32_t now = (ts_source != NULL) ? ts_source() : 0u;
+  bool took_mutex = elog_enter_cs(&s_log_mutex);
+  for (int i = 0; i < ELOG_COALESCE_SLOTS; i++)
+  {
+    elog_coalesce_report(&s_coalesce[i], now);
+  }
+  elog_exit_cs(&s_log_mutex, took_mutex);
+#endif
+}
+
+/**
+ * @brief Thread-safe version of log_subscribe
+ * @param fn: Function to call for each log message
+ * @param threshold: Minimum level to send to this subscriber
+ * @return Error code
+ */
+elog_err_t elog_subscribe(log_subscriber_t fn, elog_level_t threshold)
+{
+  return elog_subscribe_ex(fn, threshold, ELOG_MODULE_MASK_ALL);
+}
+
+/**
+ * @brief Add or update a subscriber entry (matched by its function pointer)
+ * @param entry: Entry to install
+ * @return Error code
+ */
+static elog_err_t elog_subscribe_entry(const subscriber_entry_t *entry)
+{
+  /* Serialize writers only; logging keeps running on the published table */
+  bool took_mutex = elog_enter_cs(&s_sub_mutex);
+
+  elog_err_t result = ELOG_ERR_SUBSCRIBERS_EXCEEDED;
+  subscriber_table_t *next = elog_subs_begin_update();
+
+  /* Check if already subscribed */
+  for (int i = 0; i < next->count; i++)
+  {
+    if (next->entries[i].fn == entry->fn && next->entries[i].record_fn == entry->record_fn)
+    {
+      /* Update existing subscription, keeping its backpressure policy */
+      elog_backpressure_t *bp = next->entries[i].bp;
+      next->entries[i] = *entry;
+      next->entries[i].bp = bp;
+      result = ELOG_ERR_NONE;
+      break;
     }
+  }
 
-    /* Add new subscriber */
-    s_subscribers[s_num_subscribers].fn = fn;
-    s_subscribers[s_num_subscribers].threshold = threshold;
-    s_num_subscribers++;
+  /* Add new subscriber */
+  if (result != ELOG_ERR_NONE && next->count < ELOG_MAX_SUBSCRIBERS)
+  {
+    next->entries[next->count++] = *entry;
     result = ELOG_ERR_NONE;
   }
 
-exit:
+  if (result == ELOG_ERR_NONE) { elog_subs_publish(next); }
+
   /* Give mutex only if we took it */
-  elog_exit_cs(took_mutex);
+  elog_exit_cs(&s_sub_mutex, took_mutex);
   return result;
 }
 
 /**
- * @brief Thread-safe version of log_unsubscribe
- * @param fn: Function to unsubscribe
+ * @brief Remove the subscriber entry matching fn / record_fn
  * @return Error code
  */
-elog_err_t elog_unsubscribe(log_subscriber_t fn)
+static elog_err_t elog_unsubscribe_entry(log_subscriber_t fn, elog_record_subscriber_t record_fn)
 {
-  /* Try to acquire mutex if RTOS is ready and mutex exists */
-  bool took_mutex = false;
-  took_mutex = elog_enter_cs();
+  /* Serialize writers only; logging keeps running on the published table */
+  bool took_mutex = elog_enter_cs(&s_sub_mutex);
 
   elog_err_t result = ELOG_ERR_NOT_SUBSCRIBED;
+  subscriber_table_t *next = elog_subs_begin_update();
 
-  for (int i = 0; i < s_num_subscribers; i++)
+  for (int i = 0; i < next->count; i++)
   {
-    if (s_subscribers[i].fn == fn)
+    if (next->entries[i].fn == fn && next->entries[i].record_fn == record_fn)
     {
-      for (int j = i; j < s_num_subscribers - 1; j++)
+      /* Compacting the spare table is invisible to readers until it is published */
+      for (int j = i; j < next->count - 1; j++)
       {
-        s_subscribers[j] = s_subscribers[j + 1];
+        next->entries[j] = next->entries[j + 1];
       }
 
-      s_num_subscribers--;
-      s_subscribers[s_num_subscribers].fn = NULL;
-      s_subscribers[s_num_subscribers].threshold = ELOG_LEVEL_ALWAYS;
+      next->count--;
+      memset(&next->entries[next->count], 0, sizeof(next->entries[next->count]));
 
+      elog_subs_publish(next);
       result = ELOG_ERR_NONE;
       break;
     }
   }
 
   /* Give mutex only if we took it */
-  elog_exit_cs(took_mutex);
+  elog_exit_cs(&s_sub_mutex, took_mutex);
+  return result;
+}
+
+/**
+ * @brief Subscribe a function for records of selected modules
+ * @param fn: Function to call for each log message
+ * @param threshold: Minimum level to send to this subscriber
+ * @param module_mask: Modules to deliver (ELOG_MODULE_BIT(m) | ...)
+ * @return Error code
+ */
+elog_err_t elog_subscribe_ex(log_subscriber_t fn, elog_level_t threshold, elog_module_mask_t module_mask)
+{
+  if (fn == NULL) { return ELOG_ERR_INVALID_PARAM; }
+  subscriber_entry_t entry = {.fn = fn, .record_fn = NULL, .threshold = threshold, .module_mask = module_mask, .bp = NULL};
+  return elog_subscribe_entry(&entry);
+}
+
+/**
+ * @brief Thread-safe version of log_unsubscribe
+ * @note  Records already being dispatched from an older snapshot may still reach fn
+ *        after this function returns.
+ * @param fn: Function to unsubscribe
+ * @return Error code
+ */
+elog_err_t elog_unsubscribe(log_subscriber_t fn)
+{
+  return elog_unsubscribe_entry(fn, NULL);
+}
+
+/**
+ * @brief Subscribe a structured record consumer
+ * @param fn: Function to call for each record
+ * @param threshold: Minimum level to send to this subscriber
+ * @param module_mask: Modules to deliver (ELOG_MODULE_BIT(m) | ..., or ELOG_MODULE_MASK_ALL)
+ * @return Error code
+ */
+elog_err_t elog_subscribe_record(elog_record_subscriber_t fn, elog_level_t threshold, elog_module_mask_t module_mask)
+{
+  if (fn == NULL) { return ELOG_ERR_INVALID_PARAM; }
+  subscriber_entry_t entry = {.fn = NULL, .record_fn = fn, .threshold = threshold, .module_mask = module_mask, .bp = NULL};
+  return elog_subscribe_entry(&entry);
+}
+
+/**
+ * @brief Unsubscribe a structured record consumer
+ * @param fn: Function to unsubscribe
+ * @return Error code
+ */
+elog_err_t elog_unsubscribe_record(elog_record_subscriber_t fn)
+{
+  if (fn == NULL) { return ELOG_ERR_INVALID_PARAM; }
+  return elog_unsubscribe_entry(NULL, fn);
+}
+
+/**
+ * @brief Attach a backpressure policy to a subscribed text subscriber
+ * @param fn: Subscriber, already registered with elog_subscribe()/elog_subscribe_ex()
+ * @param bp: State storage, must outlive the subscription; NULL detaches the policy
+ * @param cfg: Policy (ignored when bp is NULL)
+ * @note  Waits for the record being delivered, so it must not be called from a subscriber.
+ * @return Error code
+ */
+elog_err_t elog_set_backpressure(log_subscriber_t fn, elog_backpressure_t *bp, const elog_bp_config_t *cfg)
+{
+  if (fn == NULL || (bp != NULL && cfg == NULL)) { return ELOG_ERR_INVALID_PARAM; }
+  if (bp != NULL)
+  {
+    bool valid = (cfg->policy == ELOG_BP_DROP_NEWEST) ||
+                 (cfg->policy == ELOG_BP_DROP_OLDEST && cfg->backlog != NULL && cfg->backlog_size > 2u) ||
+                 (cfg->policy == ELOG_BP_BLOCK && cfg->wait_ms != NULL) ||
+                 (cfg->policy == ELOG_BP_SPILL && cfg->spill != NULL);
+    if (!valid) { return ELOG_ERR_INVALID_PARAM; }
+  }
+
+  /* Every dispatch runs under s_log_mutex: holding it (before s_sub_mutex, the order logging uses)
+   * means no record is using bp while it is reset, and none uses the old policy after the publish */
+  bool took_log_mutex = elog_enter_cs(&s_log_mutex);
+  bool took_mutex = elog_enter_cs(&s_sub_mutex);
+  elog_err_t result = ELOG_ERR_NOT_SUBSCRIBED;
+  subscriber_table_t *next = elog_subs_begin_update();
+  for (int i = 0; i < next->count; i++)
+  {
+    if (next->entries[i].fn == fn && next->entries[i].record_fn == NULL)
+    {
+      if (bp != NULL)
+      {
+        memset(bp, 0, sizeof(*bp));
+        bp->cfg = *cfg;
+        bp->fn = fn;
+      }
+      next->entries[i].bp = bp;
+      elog_subs_publish(next);
+      result = ELOG_ERR_NONE;
+      break;
+    }
+  }
+  elog_exit_cs(&s_sub_mutex, took_mutex);
+  elog_exit_cs(&s_log_mutex, took_log_mutex);
   return result;
 }
 
+/**
+ * @brief Retry the backlog of an ELOG_BP_DROP_OLDEST subscriber
+ * @param bp: State passed to elog_set_backpressure()
+ * @return Number of backlog lines delivered
+ */
+uint32_t elog_backpressure_flush(elog_backpressure_t *bp)
+{
+  if (bp == NULL || bp->fn == NULL) { return 0; }
+  uint32_t delivered = 0;
+  bool took_mutex = elog_enter_cs(&s_log_mutex);
+  elog_bp_retry(bp, &delivered);
+  elog_exit_cs(&s_log_mutex, took_mutex);
+  return delivered;
+}
+
+/**
+ * @brief Snapshot the counters of a policy (consistent with concurrent logging)
+ * @param bp: State passed to elog_set_backpressure()
+ * @param stats: Output
+ */
+void elog_get_backpressure_stats(const elog_backpressure_t *bp, elog_bp_stats_t *stats)
+{
+  if (bp == NULL || stats == NULL) { return; }
+  bool took_mutex = elog_enter_cs(&s_log_mutex);
+  *stats = bp->stats;
+  elog_exit_cs(&s_log_mutex, took_mutex);
+}
+
 /**
  * @brief Set log threshold for a specific module
  * @param module: Module identifier
@@ -382,7 +2054,10 @@ elog_err_t elog_unsubscribe(log_subscriber_t fn)
 elog_err_t elog_set_module_threshold(elog_module_t module, elog_level_t threshold)
 {
   if (module >= ELOG_MD_MAX) { return ELOG_ERR_INVALID_LEVEL; }
-  module_log_levels[module].threshold = threshold;
+
+  /* Lock-free: safe from any task or ISR, never waits on a logging or subscribing thread */
+  __atomic_store_n(&s_module_user_thresholds[module], (uint8_t)threshold, __ATOMIC_SEQ_CST);
+  elog_gate_refresh((int)module);
   return ELOG_ERR_NONE;
 }
 
@@ -394,5 +2069,234 @@ elog_err_t elog_set_module_threshold(elog_module_t module, elog_level_t threshol
 elog_level_t elog_get_module_threshold(elog_module_t module)
 {
   if (module >= ELOG_MD_MAX) { return ELOG_DEFAULT_THRESHOLD; }
-  return module_log_levels[module].threshold;
+  return (elog_level_t)__atomic_load_n(&s_module_user_thresholds[module], __ATOMIC_RELAXED);
+}
+
+/* ========================================================================== */
+/* Bulk Runtime Level Control */
+/* ========================================================================== */
+
+/**
+ * @brief Set the thresholds of several modules from a byte array
+ * @param levels: levels[m] is the new threshold of module m (ELOG_LEVEL_*), 0 leaves it unchanged
+ * @param count: Number of entries (at most ELOG_MD_MAX are used)
+ * @return ELOG_ERR_NONE, or ELOG_ERR_INVALID_LEVEL if an entry is not a level (nothing is applied)
+ */
+elog_err_t elog_set_levels(const uint8_t *levels, size_t count)
+{
+  if (levels == NULL) { return ELOG_ERR_INVALID_PARAM; }
+  if (count > ELOG_MD_MAX) { count = ELOG_MD_MAX; }
+
+  for (size_t m = 0; m < count; m++)
+  {
+    if (levels[m] != 0u && (levels[m] < ELOG_LEVEL_TRACE || levels[m] > ELOG_LEVEL_ALWAYS))
+    {
+      return ELOG_ERR_INVALID_LEVEL;
+    }
+  }
+  for (size_t m = 0; m < count; m++)
+  {
+    if (levels[m] != 0u) { elog_set_module_threshold((elog_module_t)m, (elog_level_t)levels[m]); }
+  }
+  return ELOG_ERR_NONE;
+}
+
+/**
+ * @brief Copy the current thresholds into a byte array (same layout as elog_set_levels)
+ * @param levels: Destination, levels[m] receives the threshold of module m
+ * @param count: Size of levels
+ * @return Number of entries written
+ */
+size_t elog_get_levels(uint8_t *levels, size_t count)
+{
+  if (levels == NULL) { return 0; }
+  if (count > ELOG_MD_MAX) { count = ELOG_MD_MAX; }
+  for (size_t m = 0; m < count; m++)
+  {
+    levels[m] = __atomic_load_n(&s_module_user_thresholds[m], __ATOMIC_RELAXED);
+  }
+  return count;
+}
+
+/**
+ * @brief Parse a level token: a letter (T/I/D/W/E/C/A, see elog_level_name), its full name
+ *        (TRACE, INFO, DEBUG, WARNING, ERROR, CRITICAL, ALWAYS, any case) or a number
+ * @return true if the whole token is a level
+ */
+static bool elog_parse_level(const char *s, size_t len, uint8_t *level)
+{
+  static const char *const names[] = {"TRACE", "INFO", "DEBUG", "WARNING", "ERROR", "CRITICAL", "ALWAYS"};
+  if (len == 0u) { return false; }
+  if (*s >= '0' && *s <= '9')
+  {
+    unsigned v = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+      if (s[i] < '0' || s[i] > '9' || v >= 1000u) { return false; }
+      v = v * 10u + (unsigned)(s[i] - '0');
+    }
+    if (v < ELOG_LEVEL_TRACE || v > ELOG_LEVEL_ALWAYS) { return false; }
+    *level = (uint8_t)v;
+    return true;
+  }
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+  {
+    size_t k = 0;
+    while (k < len && names[i][k] != '\0' && (s[k] & ~0x20) == names[i][k]) { k++; }
+    if (k == len && (len == 1u || names[i][k] == '\0'))
+    {
+      *level = (uint8_t)(ELOG_LEVEL_TRACE + i);
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Entry separators of a level command; blanks are also allowed around '=' */
+static bool elog_levels_is_sep(char c)
+{
+  return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/**
+ * @brief Walk a level command, applying it only when apply is true
+ * @return ELOG_ERR_NONE, or ELOG_ERR_INVALID_PARAM at the first malformed entry
+ */
+static elog_err_t elog_run_levels_cmd(const char *cmd, bool apply)
+{
+  const char *p = cmd;
+  for (;;)
+  {
+    while (elog_levels_is_sep(*p)) { p++; }
+    if (*p == '\0') { return ELOG_ERR_NONE; }
+
+    /* Module: decimal index, name from the module list, or '*' for all */
+    size_t len = 0;
+    while (p[len] != '\0' && p[len] != '=' && !elog_levels_is_sep(p[len])) { len++; }
+    int module = -1;
+    if (len == 1u && *p == '*')
+    {
+      /* All modules */
+    }
+    else if (len != 0u && *p >= '0' && *p <= '9')
+    {
+      module = 0;
+      for (size_t i = 0; i < len; i++)
+      {
+        if (p[i] < '0' || p[i] > '9' || module >= ELOG_MD_MAX) { return ELOG_ERR_INVALID_PARAM; }
+        module = module * 10 + (p[i] - '0');
+      }
+      if (module >= ELOG_MD_MAX) { return ELOG_ERR_INVALID_PARAM; }
+    }
+    else
+    {
+      module = (int)elog_module_from_name(p, len);
+      if (module >= ELOG_MD_MAX) { return ELOG_ERR_INVALID_PARAM; }
+    }
+    p += len;
+
+    while (*p == ' ' || *p == '\t') { p++; }
+    if (*p++ != '=') { return ELOG_ERR_INVALID_PARAM; }
+    while (*p == ' ' || *p == '\t') { p++; }
+
+    uint8_t level;
+    len = 0;
+    while (p[len] != '\0' && p[len] != '=' && !elog_levels_is_sep(p[len])) { len++; }
+    if (!elog_parse_level(p, len, &level)) { return ELOG_ERR_INVALID_PARAM; }
+    p += len;
+
+    if (apply)
+    {
+      for (int m = (module < 0) ? 0 : module; m < ((module < 0) ? ELOG_MD_MAX : module + 1); m++)
+      {
+        elog_set_module_threshold((elog_module_t)m, (elog_level_t)level);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Set module thresholds from a packed command, e.g. received over a debug UART
+ * @param cmd: Entries "module=level" separated by ',', ';' or whitespace, applied left to right;
+ *             blanks around '=' are allowed. module is the elog_module_t index, its name
+ *             (elog_module_name) or '*' for every module; level is a letter (T/I/D/W/E/C/A),
+ *             its full name (e.g. DEBUG, any case) or its numeric value.
+ *             Example: "*=E, SENSOR = TRACE" (sensor at TRACE, rest ERROR).
+ * @return ELOG_ERR_NONE, or ELOG_ERR_INVALID_PARAM if the command is malformed (nothing is applied)
+ */
+elog_err_t elog_set_levels_str(const char *cmd)
+{
+  if (cmd == NULL) { return ELOG_ERR_INVALID_PARAM; }
+  elog_err_t err = elog_run_levels_cmd(cmd, false);
+  if (err != ELOG_ERR_NONE) { return err; }
+  return elog_run_levels_cmd(cmd, true);
+}
+
+/* ========================================================================== */
+/* Sampling */
+/* ========================================================================== */
+
+/**
+ * @brief Keep 1 in rate records of a module at levels up to ELOG_SAMPLING_MAX_LEVEL
+ * @param module: Module identifier
+ * @param rate: Sampling rate N, 0 or 1 turns sampling off
+ * @param mode: ELOG_SAMPLE_EVERY_NTH or ELOG_SAMPLE_RANDOM
+ * @return ELOG_ERR_NONE, ELOG_ERR_INVALID_PARAM for a bad module or mode,
+ *         ELOG_ERR_INVALID_STATE if built with ELOG_SAMPLING_ENABLE = NO
+ */
+elog_err_t elog_set_module_sampling(elog_module_t module, uint16_t rate, elog_sample_mode_t mode)
+{
+  if ((unsigned)module >= (unsigned)ELOG_MD_MAX || (mode != ELOG_SAMPLE_EVERY_NTH && mode != ELOG_SAMPLE_RANDOM))
+  {
+    return ELOG_ERR_INVALID_PARAM;
+  }
+#if (ELOG_SAMPLING_ENABLE == YES)
+  __atomic_store_n(&s_sample_count[module], 0u, __ATOMIC_RELAXED);
+  __atomic_store_n(&s_sample_config[module], (uint32_t)rate | ((uint32_t)mode << 16), __ATOMIC_RELAXED);
+  return ELOG_ERR_NONE;
+#else
+  (void)rate;
+  return ELOG_ERR_INVALID_STATE;
+#endif
+}
+
+/**
+ * @brief Get the sampling rate of a module
+ * @param module: Module identifier
+ * @return N of "1 in N", 1 when the module is not sampled
+ */
+uint16_t elog_get_module_sampling(elog_module_t module)
+{
+#if (ELOG_SAMPLING_ENABLE == YES)
+  if ((unsigned)module < (unsigned)ELOG_MD_MAX)
+  {
+    uint16_t n = (uint16_t)__atomic_load_n(&s_sample_config[module], __ATOMIC_RELAXED);
+    return (n > 1u) ? n : 1u;
+  }
+#else
+  (void)module;
+#endif
+  return 1u;
+}
+
+/**
+ * @brief Get a copy of the runtime counters
+ * @param stats: Destination
+ */
+void elog_get_stats(elog_stats_t *stats)
+{
+  if (stats == NULL) { return; }
+  bool took_mutex = elog_enter_cs(&s_log_mutex);
+  *stats = s_stats;
+  elog_exit_cs(&s_log_mutex, took_mutex);
+}
+
+/**
+ * @brief Reset the runtime counters
+ */
+void elog_reset_stats(void)
+{
+  bool took_mutex = elog_enter_cs(&s_log_mutex);
+  memset(&s_stats, 0, sizeof(s_stats));
+  elog_exit_cs(&s_log_mutex, took_mutex);
 }
@@ -32,36 +32,18 @@
 #define ELOG_MUTEX_TIMEOUT_MS 0 /* Mutex timeout in milliseconds, 0 means no wait */
 #define ELOG_USE_COLOR 0  /* Set to 0 to disable colors in elog_console_subscriber */
 
-// Module list configuration
+// Module list configuration (X-macro, see eLog_modules.h)
+#if defined(ELOG_MODULES_CONFIG_FILE)
+#include ELOG_MODULES_CONFIG_FILE
+#endif
+#include "eLog_modules.h"
+
+#define ELOG_MODULE_ENUM(name) ELOG_MD_##name,
 typedef enum {
-  ELOG_MD_DEFAULT = 0,
-  ELOG_MD_ERROR,
-  ELOG_MD_RNG,
-  ELOG_MD_BLE_HOST,
-  ELOG_MD_BLE_HCI,
-  ELOG_MD_BLE_LL,
-  ELOG_MD_BLE_GATT,
-  ELOG_MD_BLE_APP,
-  ELOG_MD_SVCCTL,
-  ELOG_MD_P2P_SERVER,
-  ELOG_MD_BLE_TIMER,
-  ELOG_MD_SENSOR,
-  ELOG_MD_BT,
-  ELOG_MD_UI,
-  ELOG_MD_FLASH,
-  ELOG_MD_BPKA,
-  ELOG_MD_AMM,
-  ELOG_MD_TEMPMEAS,
-  ELOG_MD_TX,
-  ELOG_MD_HW_PMIC,
-  ELOG_MD_HW_GPIO,
-  ELOG_MD_HW_I2C,
-  ELOG_MD_HW_SPI,
-  ELOG_MD_HW_CURRENT_SENSE,
-  ELOG_MD_HW_LCD,
-  ELOG_MD_APP_PD,
+  ELOG_MODULE_LIST(ELOG_MODULE_ENUM)
   ELOG_MD_MAX
 } elog_module_t;
+#undef ELOG_MODULE_ENUM
 
 /* Local definitions for independence from app_conf.h */
 #ifndef YES
@@ -122,6 +104,85 @@ static inline const char *debug_get_filename(const char *fullpath) {
 #define ELOG_DEFAULT_THRESHOLD ELOG_LEVEL_ALWAYS  /* Fallback if all disabled */
 #endif
 
+/* Formatter selection: YES = built-in eLog printf engine (elog_vsnprintf), NO = libc vsnprintf.
+ * The built-in engine covers integers, hex/octal, chars, strings, pointers and %f/%e/%g
+ * floats (no long double) without heap or locale support, and is considerably smaller than
+ * newlib's printf. */
+#ifndef ELOG_USE_BUILTIN_PRINTF
+#define ELOG_USE_BUILTIN_PRINTF NO
+#endif
+
+/* Per-call-site rate limiting: YES = every ELOG_* statement owns a token bucket of
+ * ELOG_RATELIMIT_BURST records refilled at ELOG_RATELIMIT_PER_SEC. Records beyond it are
+ * dropped before argument evaluation and reported as "N messages suppressed".
+ * Requires a timestamp source (elog_set_timestamp_source); without one nothing is limited. */
+#ifndef ELOG_RATELIMIT_ENABLE
+#define ELOG_RATELIMIT_ENABLE NO
+#endif
+#ifndef ELOG_RATELIMIT_BURST
+#define ELOG_RATELIMIT_BURST 10
+#endif
+#ifndef ELOG_RATELIMIT_PER_SEC
+#define ELOG_RATELIMIT_PER_SEC 5
+#endif
+
+/* Duplicate coalescing: YES = a record with the same fmt pointer and argument values as one
+ * logged less than ELOG_COALESCE_WINDOW_MS ago is not formatted; the run is reported as
+ * "repeated N times: <fmt>". ELOG_COALESCE_SLOTS recent messages are tracked.
+ * Requires a timestamp source (elog_set_timestamp_source); without one nothing is coalesced. */
+#ifndef ELOG_COALESCE_ENABLE
+#define ELOG_COALESCE_ENABLE NO
+#endif
+#ifndef ELOG_COALESCE_WINDOW_MS
+#define ELOG_COALESCE_WINDOW_MS 1000
+#endif
+#ifndef ELOG_COALESCE_SLOTS
+#define ELOG_COALESCE_SLOTS 4
+#endif
+
+/* Sampling: YES = elog_set_module_sampling() can keep 1 in N records of a module at levels up to
+ * ELOG_SAMPLING_MAX_LEVEL (TRACE, INFO and DEBUG by default), either every Nth record or with
+ * probability 1/N. Sampled-out records are dropped before the timestamp and formatting; kept ones
+ * carry the rate (record->sample_rate, "~N" in the text prefix) so totals can be scaled back. */
+#ifndef ELOG_SAMPLING_ENABLE
+#define ELOG_SAMPLING_ENABLE NO
+#endif
+#ifndef ELOG_SAMPLING_MAX_LEVEL
+#define ELOG_SAMPLING_MAX_LEVEL ELOG_LEVEL_DEBUG
+#endif
+
+/* Level of ELOG_SPAN_* begin/end events (gated per module like any record, never sampled) */
+#ifndef ELOG_SPAN_LEVEL
+#define ELOG_SPAN_LEVEL ELOG_LEVEL_TRACE
+#endif
+
+/* ISR fast path: YES = ELOG_* statements running in interrupt context never touch the RTOS or the
+ * formatter. They capture level, module, timestamp, format pointer and up to ELOG_ISR_MAX_ARGS
+ * argument values into a lock-free queue of ELOG_ISR_QUEUE_LEN records (power of two);
+ * elog_isr_drain() formats and delivers them later from a task. A full queue drops the record.
+ * Override ELOG_IN_ISR() to change the interrupt-context test (default: IPSR on Cortex-M). */
+#ifndef ELOG_ISR_ENABLE
+#define ELOG_ISR_ENABLE NO
+#endif
+#ifndef ELOG_ISR_QUEUE_LEN
+#define ELOG_ISR_QUEUE_LEN 16
+#endif
+#ifndef ELOG_ISR_MAX_ARGS
+#define ELOG_ISR_MAX_ARGS 6
+#endif
+
+/* Console transport: YES = elog_console_subscriber queues text into a ring_tx transmitter
+ * (ring/ring_tx.h) registered with elog_console_attach(); NO = it calls the project's
+ * LPUartQueueBuffWrite(). */
+#ifndef ELOG_CONSOLE_RING_TX
+#define ELOG_CONSOLE_RING_TX NO
+#endif
+
+/* Bytes per line of ELOG_HEXDUMP text output */
+#ifndef ELOG_HEXDUMP_BYTES_PER_LINE
+#define ELOG_HEXDUMP_BYTES_PER_LINE 16
+#endif
+
 /* Maximum number of log subscribers (console, file, memory, etc.) */
 #ifndef ELOG_MAX_SUBSCRIBERS
 #define ELOG_MAX_SUBSCRIBERS 6
@@ -155,6 +216,19 @@ typedef enum {
   ELOG_LEVEL_ALWAYS          /*!< Always logged: essential system messages */
 } elog_level_t;
 
+/* Number of distinct log levels (ELOG_LEVEL_TRACE .. ELOG_LEVEL_ALWAYS) */
+#define ELOG_LEVEL_COUNT (ELOG_LEVEL_ALWAYS - ELOG_LEVEL_TRACE + 1)
+
+/**
+ * @brief Module selection mask for subscribers (bit n selects module n)
+ */
+#ifndef ELOG_MODULE_MASK_TYPE
+#define ELOG_MODULE_MASK_TYPE uint32_t /* uint64_t for module lists of up to 64 entries */
+#endif
+typedef ELOG_MODULE_MASK_TYPE elog_module_mask_t;
+#define ELOG_MODULE_BIT(module) ((elog_module_mask_t)1u << (unsigned)(module))
+#define ELOG_MODULE_MASK_ALL    ((elog_module_mask_t)~(elog_module_mask_t)0u)
+
 /**
  * @brief Log subscriber function type
  * @param handle: Unused
@@ -164,6 +238,90 @@ typedef enum {
  */
 typedef int (*log_subscriber_t)(int handle, const char *buf, size_t len);
 
+/**
+ * @brief Timestamp source function type
+ * @return Free-running tick count (cycle counter, RTOS tick, microseconds, ...); wraps modulo 2^32
+ */
+typedef uint32_t (*elog_timestamp_fn_t)(void);
+
+/**
+ * @brief Field types of structured (ELOG_KV) records
+ */
+typedef enum {
+  ELOG_KV_U32 = 0,
+  ELOG_KV_I32,
+  ELOG_KV_U64,
+  ELOG_KV_I64,
+  ELOG_KV_X32,   /*!< Unsigned, rendered as 0x%08X in text */
+  ELOG_KV_BOOL,
+  ELOG_KV_F32,
+  ELOG_KV_STR,
+} elog_kv_type_t;
+
+/**
+ * @brief Typed key/value field of an ELOG_KV record (build with ELOG_U32() etc.)
+ */
+typedef struct {
+  const char *key;
+  uint8_t type;          /*!< elog_kv_type_t */
+  union {
+    uint32_t u32;
+    int32_t i32;
+    uint64_t u64;
+    int64_t i64;
+    bool b;
+    float f32;
+    const char *str;
+  } v;
+} elog_kv_t;
+
+#define ELOG_U32(k, x)  ((elog_kv_t){.key = (k), .type = ELOG_KV_U32, .v.u32 = (uint32_t)(x)})
+#define ELOG_I32(k, x)  ((elog_kv_t){.key = (k), .type = ELOG_KV_I32, .v.i32 = (int32_t)(x)})
+#define ELOG_U64(k, x)  ((elog_kv_t){.key = (k), .type = ELOG_KV_U64, .v.u64 = (uint64_t)(x)})
+#define ELOG_I64(k, x)  ((elog_kv_t){.key = (k), .type = ELOG_KV_I64, .v.i64 = (int64_t)(x)})
+#define ELOG_X32(k, x)  ((elog_kv_t){.key = (k), .type = ELOG_KV_X32, .v.u32 = (uint32_t)(x)})
+#define ELOG_BOOL(k, x) ((elog_kv_t){.key = (k), .type = ELOG_KV_BOOL, .v.b = (x) ? true : false})
+#define ELOG_F32(k, x)  ((elog_kv_t){.key = (k), .type = ELOG_KV_F32, .v.f32 = (float)(x)})
+#define ELOG_STR(k, x)  ((elog_kv_t){.key = (k), .type = ELOG_KV_STR, .v.str = (x)})
+
+/**
+ * @brief Log record passed to record subscribers
+ * @note  Valid only during the subscriber callback. Text is composed on demand by
+ *        elog_record_text() / elog_record_message(), so sinks that encode fmt and args
+ *        themselves never pay for formatting. Consume args through va_copy().
+ */
+typedef struct {
+  elog_module_t module;
+  elog_level_t level;
+  uint32_t sequence;     /*!< Per-module running number, as printed in the text prefix */
+  uint32_t global_sequence; /*!< Running number across all modules (gaps on an unfiltered stream = loss) */
+  uint32_t timestamp;    /*!< Timestamp source ticks at elog_message entry */
+  bool has_timestamp;    /*!< false when no timestamp source is registered */
+  const char *fmt;       /*!< Format string (stable address, usually in flash) */
+  va_list *args;         /*!< Raw format arguments */
+  const char *file;      /*!< Source file, or NULL when location logging is disabled */
+  const char *func;      /*!< Function name, or NULL */
+  int line;              /*!< Source line, or 0 */
+  const uint8_t *data;   /*!< Buffer logged by ELOG_HEXDUMP, or NULL */
+  uint32_t data_len;     /*!< Length of data */
+  const elog_kv_t *fields; /*!< Fields logged by ELOG_KV (fmt is then the event name), or NULL */
+  uint32_t field_count;  /*!< Number of fields */
+  uint16_t sample_rate;  /*!< The record stands for sample_rate records of its module (1 = not sampled) */
+  uint8_t span;          /*!< ELOG_SPAN_PHASE_BEGIN / ELOG_SPAN_PHASE_END (fmt is then the span name), or 0 */
+  uint32_t span_ticks;   /*!< End events: timestamp ticks since the matching begin */
+  /* Private: lazy text cache */
+  int text_len;
+  int body_offset;
+  int body_len;
+} elog_record_t;
+
+/**
+ * @brief Record subscriber function type
+ * @param record: Record being logged
+ * @return Always 0
+ */
+typedef int (*elog_record_subscriber_t)(const elog_record_t *record);
+
 /**
  * @brief Unified Error Codes Enumeration
  * Comprehensive error codes for logging system and MCU subsystems (0x00-0xFF)
@@ -289,6 +447,16 @@ void elog_init(void);
  */
 elog_err_t elog_subscribe(log_subscriber_t fn, elog_level_t threshold);
 
+/**
+ * @brief Subscribe a function to receive log messages from selected modules only
+ * @param fn: Function to call for each log message
+ * @param threshold: Minimum level to send to this subscriber
+ * @param module_mask: Modules to deliver (ELOG_MODULE_BIT(m) | ..., or ELOG_MODULE_MASK_ALL).
+ *                     Records from module ids outside the enum reach only ELOG_MODULE_MASK_ALL subscribers.
+ * @return Error code
+ */
+elog_err_t elog_subscribe_ex(log_subscriber_t fn, elog_level_t threshold, elog_module_mask_t module_mask);
+
 /**
  * @brief Unsubscribe a function from receiving log messages
  * @param fn: Function to unsubscribe
@@ -296,6 +464,117 @@ elog_err_t elog_subscribe(log_subscriber_t fn, elog_level_t threshold);
  */
 elog_err_t elog_unsubscribe(log_subscriber_t fn);
 
+/**
+ * @brief Subscribe a function to receive structured records instead of text
+ * @param fn: Function to call for each record
+ * @param threshold: Minimum level to send to this subscriber
+ * @param module_mask: Modules to deliver (ELOG_MODULE_BIT(m) | ..., or ELOG_MODULE_MASK_ALL)
+ * @return Error code
+ */
+elog_err_t elog_subscribe_record(elog_record_subscriber_t fn, elog_level_t threshold, elog_module_mask_t module_mask);
+
+/**
+ * @brief Unsubscribe a record subscriber
+ * @param fn: Function to unsubscribe
+ * @return Error code
+ */
+elog_err_t elog_unsubscribe_record(elog_record_subscriber_t fn);
+
+/* ========================================================================== */
+/* Subscriber Backpressure */
+/* ========================================================================== */
+
+/**
+ * @brief What happens to a line a text subscriber refuses (returns < 0, e.g. a full ring_tx)
+ */
+typedef enum {
+  ELOG_BP_DROP_NEWEST = 0, /*!< Lose the refused line (behavior without a policy) */
+  ELOG_BP_DROP_OLDEST,     /*!< Park refused lines in a backlog; a full backlog evicts its oldest lines */
+  ELOG_BP_BLOCK,           /*!< Retry once per millisecond for up to timeout_ms, then drop (holds the log mutex) */
+  ELOG_BP_SPILL,           /*!< Hand the refused line to a secondary subscriber */
+} elog_bp_policy_t;
+
+/**
+ * @brief Backpressure policy configuration
+ */
+typedef struct {
+  elog_bp_policy_t policy;
+  uint32_t timeout_ms;          /*!< ELOG_BP_BLOCK: longest wait per line */
+  void (*wait_ms)(uint32_t ms); /*!< ELOG_BP_BLOCK: delay hook (tx_thread_sleep, vTaskDelay, busy loop) */
+  log_subscriber_t spill;       /*!< ELOG_BP_SPILL: secondary subscriber */
+  uint8_t *backlog;             /*!< ELOG_BP_DROP_OLDEST: backlog storage */
+  uint32_t backlog_size;        /*!< ELOG_BP_DROP_OLDEST: backlog bytes (2-byte overhead per line) */
+} elog_bp_config_t;
+
+/**
+ * @brief Backpressure counters of one subscriber
+ */
+typedef struct {
+  uint32_t delivered;      /*!< Lines accepted, directly, after waiting or from the backlog */
+  uint32_t busy;           /*!< Times the subscriber returned < 0 */
+  uint32_t dropped_newest; /*!< Refused lines lost (no room, wait timed out, spill refused) */
+  uint32_t dropped_oldest; /*!< Backlog lines evicted for newer ones */
+  uint32_t waits;          /*!< Lines that had to wait (ELOG_BP_BLOCK) */
+  uint32_t timeouts;       /*!< Waits that ran out (ELOG_BP_BLOCK) */
+  uint32_t spilled;        /*!< Lines taken by the secondary subscriber */
+  uint32_t backlog_max;    /*!< Most backlog bytes ever used */
+} elog_bp_stats_t;
+
+/**
+ * @brief Per-subscriber backpressure state, provided by the caller (static storage)
+ */
+typedef struct {
+  elog_bp_config_t cfg;
+  elog_bp_stats_t stats;
+  /* Private */
+  log_subscriber_t fn;
+  uint32_t head;
+  uint32_t used;
+} elog_backpressure_t;
+
+/**
+ * @brief Attach a backpressure policy to a subscribed text subscriber
+ * @param fn: Subscriber, already registered with elog_subscribe()/elog_subscribe_ex()
+ * @param bp: State storage, must outlive the subscription; NULL detaches the policy
+ * @param cfg: Policy (ignored when bp is NULL)
+ * @note  Applies to text subscribers only. Attaching resets bp's counters and backlog. The call
+ *        waits for the record being delivered, so no delivery sees bp half reset and, once it
+ *        returns, none still uses the previous policy. Do not call it from a subscriber.
+ * @return ELOG_ERR_NONE, ELOG_ERR_NOT_SUBSCRIBED, or ELOG_ERR_INVALID_PARAM if the policy lacks
+ *         its hook (BLOCK: wait_ms, SPILL: spill, DROP_OLDEST: backlog)
+ */
+elog_err_t elog_set_backpressure(log_subscriber_t fn, elog_backpressure_t *bp, const elog_bp_config_t *cfg);
+
+/**
+ * @brief Retry the backlog of an ELOG_BP_DROP_OLDEST subscriber (e.g. from the log task once the output drains)
+ * @param bp: State passed to elog_set_backpressure()
+ * @return Number of backlog lines delivered
+ */
+uint32_t elog_backpressure_flush(elog_backpressure_t *bp);
+
+/**
+ * @brief Snapshot the counters of a policy
+ * @param bp: State passed to elog_set_backpressure()
+ * @param stats: Output
+ */
+void elog_get_backpressure_stats(const elog_backpressure_t *bp, elog_bp_stats_t *stats);
+
+/**
+ * @brief Get the full text line of a record (formatted on first use, shared with text subscribers)
+ * @param record: Record passed to a record subscriber
+ * @param len: Receives the text length (may be NULL)
+ * @return Text, valid during the callback
+ */
+const char *elog_record_text(const elog_record_t *record, size_t *len);
+
+/**
+ * @brief Get only the user message of a record (no prefix, color or newline)
+ * @param record: Record passed to a record subscriber
+ * @param len: Receives the message length (may be NULL)
+ * @return Message, not NUL-terminated at len; valid during the callback
+ */
+const char *elog_record_message(const elog_record_t *record, size_t *len);
+
 /**
  * @brief Get the string name of a log level
  * @param level: Log level
@@ -303,6 +582,21 @@ elog_err_t elog_unsubscribe(log_subscriber_t fn);
  */
 const char *elog_level_name(elog_level_t level);
 
+/**
+ * @brief Get the name of a module as spelled in the module list (without the ELOG_MD_ prefix)
+ * @param module: Module identifier
+ * @return Module name, or "?" for ids outside the list
+ */
+const char *elog_module_name(elog_module_t module);
+
+/**
+ * @brief Look up a module by name (case-insensitive, without the ELOG_MD_ prefix)
+ * @param name: Module name
+ * @param len: Name length
+ * @return Module identifier, or ELOG_MD_MAX if no module has that name
+ */
+elog_module_t elog_module_from_name(const char *name, size_t len);
+
 /**
  * @brief Get the automatically calculated threshold level
  * @return The ELOG_DEFAULT_THRESHOLD value
@@ -314,6 +608,7 @@ elog_level_t elog_get_auto_threshold(void);
  * @param module: Module identifier
  * @param threshold: Log level threshold
  * @return ELOG_ERR_NONE on success
+ * @note Lock-free; callable from any task or ISR while other threads log
  */
 elog_err_t elog_set_module_threshold(elog_module_t module, elog_level_t threshold);
 
@@ -324,6 +619,185 @@ elog_err_t elog_set_module_threshold(elog_module_t module, elog_level_t threshol
  */
 elog_level_t elog_get_module_threshold(elog_module_t module);
 
+/**
+ * @brief Set the thresholds of several modules from a byte array
+ * @param levels: levels[m] is the new threshold of module m (ELOG_LEVEL_*), 0 leaves it unchanged
+ * @param count: Number of entries (at most ELOG_MD_MAX are used)
+ * @return ELOG_ERR_NONE, or ELOG_ERR_INVALID_LEVEL if an entry is not a level (nothing is applied)
+ */
+elog_err_t elog_set_levels(const uint8_t *levels, size_t count);
+
+/**
+ * @brief Copy the current thresholds into a byte array (same layout as elog_set_levels)
+ * @param levels: Destination, levels[m] receives the threshold of module m
+ * @param count: Size of levels
+ * @return Number of entries written
+ */
+size_t elog_get_levels(uint8_t *levels, size_t count);
+
+/**
+ * @brief Set module thresholds from a packed command, e.g. received over a debug UART
+ * @param cmd: Entries "module=level" separated by ',', ';' or whitespace, applied left to right;
+ *             blanks around '=' are allowed. module is the elog_module_t index, its name
+ *             (elog_module_name) or '*' for every module; level is a letter (T/I/D/W/E/C/A),
+ *             its full name (e.g. DEBUG, any case) or its numeric value.
+ *             Example: "*=E, SENSOR = TRACE" (sensor at TRACE, rest ERROR).
+ * @return ELOG_ERR_NONE, or ELOG_ERR_INVALID_PARAM if the command is malformed (nothing is applied)
+ */
+elog_err_t elog_set_levels_str(const char *cmd);
+
+/**
+ * @brief Sampling modes (see elog_set_module_sampling)
+ */
+typedef enum {
+  ELOG_SAMPLE_EVERY_NTH = 0, /*!< Deterministic: records 0, N, 2N, ... of the module are kept */
+  ELOG_SAMPLE_RANDOM,        /*!< Each record is kept with probability 1/N (no aliasing with periodic loops) */
+} elog_sample_mode_t;
+
+/**
+ * @brief Keep 1 in @p rate records of a module at levels up to ELOG_SAMPLING_MAX_LEVEL
+ * @param module: Module identifier
+ * @param rate: Sampling rate N, 0 or 1 turns sampling off
+ * @param mode: ELOG_SAMPLE_EVERY_NTH or ELOG_SAMPLE_RANDOM
+ * @return ELOG_ERR_NONE, ELOG_ERR_INVALID_PARAM for a bad module or mode,
+ *         ELOG_ERR_INVALID_STATE if built with ELOG_SAMPLING_ENABLE = NO
+ * @note Lock-free; warnings and above are never sampled.
+ */
+elog_err_t elog_set_module_sampling(elog_module_t module, uint16_t rate, elog_sample_mode_t mode);
+
+/**
+ * @brief Get the sampling rate of a module
+ * @param module: Module identifier
+ * @return N of "1 in N", 1 when the module is not sampled
+ */
+uint16_t elog_get_module_sampling(elog_module_t module);
+
+/**
+ * @brief Runtime counters for tuning thresholds and subscribers
+ */
+typedef struct {
+  uint32_t formatted;      /*!< Records formatted */
+  uint32_t undelivered;    /*!< Records that passed the early check but found no subscriber at dispatch */
+  uint32_t rejected_early; /*!< Records that reached elog_message and were dropped before formatting */
+  uint32_t suppressed;     /*!< Records dropped by per-call-site rate limiting */
+  uint32_t coalesced;      /*!< Records folded into a "repeated N times" summary */
+  uint32_t sampled_out;    /*!< Records dropped by per-module sampling */
+  uint32_t isr_deferred;   /*!< Records captured in interrupt context for elog_isr_drain() */
+  uint32_t isr_dropped;    /*!< Interrupt-context records lost (queue full, too many arguments, hexdump/KV) */
+  uint32_t sink_busy;      /*!< Lines refused by a text subscriber (returned < 0) */
+} elog_stats_t;
+
+/**
+ * @brief Get a copy of the runtime counters
+ * @param stats: Destination
+ */
+void elog_get_stats(elog_stats_t *stats);
+
+/**
+ * @brief Reset the runtime counters
+ */
+void elog_reset_stats(void);
+
+/**
+ * @brief Effective per-module gate, indexed by elog_module_t
+ * @note  max(module threshold, lowest level any subscriber accepts for the module); 0xFF when no
+ *        subscriber listens to the module. Globally visible so the ELOG_* macros can reject
+ *        disabled statements inline. Maintained by eLog; do not modify directly.
+ */
+extern uint8_t elog_module_thresholds[ELOG_MD_MAX];
+
+/*
+ * Per-module compile-time floor levels.
+ * Define ELOG_MODULE_MIN_LEVELS (before including eLog.h, or on the command line) as a list of
+ * ELOG_MODULE_MIN_LEVEL(module, LEVEL) entries, LEVEL being TRACE/INFO/DEBUG/WARNING/ERROR/CRITICAL/ALWAYS:
+ *
+ *   #define ELOG_MODULE_MIN_LEVELS \
+ *     ELOG_MODULE_MIN_LEVEL(ELOG_MD_BLE_LL, WARNING) \
+ *     ELOG_MODULE_MIN_LEVEL(ELOG_MD_SENSOR, INFO)
+ *
+ * Statements below the floor of a constant module fold to nothing when optimization is enabled
+ * (call, arguments and format string are all removed) and cannot be re-enabled at runtime.
+ * Modules without an entry have no floor beyond the global ELOG_DEBUG_*_ON switches.
+ */
+#ifndef ELOG_MODULE_MIN_LEVELS
+#define ELOG_MODULE_MIN_LEVELS
+#endif
+#define ELOG_MODULE_MIN_LEVEL(module, level) case (module): return (unsigned)ELOG_LEVEL_##level;
+
+/**
+ * @brief Compile-time floor of a module (0 when it has none)
+ * @note  A switch rather than a table: no data is emitted per translation unit, a constant module
+ *        folds to a constant, and a module listed twice fails to compile.
+ */
+static inline unsigned elog_module_min_level(unsigned module)
+{
+  switch (module)
+  {
+  ELOG_MODULE_MIN_LEVELS
+  default: return 0u;
+  }
+}
+
+/**
+ * @brief Compile-time floor test (constant-folded for constant module and level)
+ */
+#define ELOG_LEVEL_COMPILED_IN(module, level) ((unsigned)(level) >= elog_module_min_level((unsigned)(module)))
+
+/**
+ * @brief Inline threshold test used by the logging macros (one load, one compare)
+ * @note  module is evaluated more than once; pass a constant or a side-effect free expression.
+ *        The gate byte is read with a relaxed atomic load (a plain byte load on every target) so
+ *        runtime level changes from other threads are well defined.
+ */
+#define ELOG_LEVEL_ENABLED(module, level) \
+  (ELOG_LEVEL_COMPILED_IN(module, level) && \
+   ((unsigned)(level) >= (((unsigned)(module) < (unsigned)ELOG_MD_MAX) ? \
+                          (unsigned)__atomic_load_n(&elog_module_thresholds[(module)], __ATOMIC_RELAXED) : \
+                          (unsigned)ELOG_DEFAULT_THRESHOLD)))
+
+/**
+ * @brief Per-call-site token bucket (one static instance per ELOG_* statement)
+ */
+typedef struct elog_ratelimit {
+  uint32_t last_refill;           /*!< Timestamp of the last token refill */
+  uint32_t suppressed;            /*!< Records dropped since the last summary */
+  uint16_t tokens;
+  uint16_t line;                  /*!< Source line of the call site, shown in the summary */
+  uint8_t module;                 /*!< Recorded on first suppression for elog_ratelimit_flush() */
+  uint8_t level;
+  bool primed;
+  bool registered;                /*!< Linked into the flush list */
+  struct elog_ratelimit *next;
+} elog_ratelimit_t;
+
+/**
+ * @brief Take a token from a call site's bucket
+ * @note  Emits the pending "N messages suppressed" summary when a throttled site resumes.
+ * @param site: Call-site state
+ * @param module: Module of the statement
+ * @param level: Level of the statement
+ * @return true if the record may be logged
+ */
+bool elog_ratelimit_pass(elog_ratelimit_t *site, elog_module_t module, elog_level_t level);
+
+/**
+ * @brief Emit summaries for every call site with suppressed records (e.g. from an idle task)
+ */
+void elog_ratelimit_flush(void);
+
+/**
+ * @brief Emit pending "repeated N times" summaries of coalesced records (e.g. from an idle task)
+ */
+void elog_coalesce_flush(void);
+
+#if (ELOG_RATELIMIT_ENABLE == YES)
+#define ELOG_SITE_PASS(module, level) \
+    static elog_ratelimit_t elog_site_limit_ = {.line = (uint16_t)__LINE__}; \
+    if (!elog_ratelimit_pass(&elog_site_limit_, (module), (level))) { break; }
+#else
+#define ELOG_SITE_PASS(module, level)
+#endif
+
 #if ENABLE_DEBUG_MESSAGES_WITH_LOCATION
 /**
  * @brief Send a formatted message with location info to all subscribers
@@ -335,7 +809,12 @@ elog_level_t elog_get_module_threshold(elog_module_t module);
  * @param ...: Format arguments
  */
 void elog_message_with_location(elog_module_t module, elog_level_t level, const char *file, const char *func, int line, const char *fmt, ...);
-#define LOG_MESSAGE_WITH_LOCATION(module, level, file, func, line, ...) elog_message_with_location(module, level, file, func, line, __VA_ARGS__)
+#define LOG_MESSAGE_WITH_LOCATION(module, level, file, func, line, ...) do { \
+    if (ELOG_LEVEL_ENABLED(module, level)) { \
+      ELOG_SITE_PASS(module, level) \
+      elog_message_with_location(module, level, file, func, line, __VA_ARGS__); \
+    } \
+} while(0)
 #else
 /**
  * @brief Send a formatted message to all subscribers
@@ -344,12 +823,631 @@ void elog_message_with_location(elog_module_t module, elog_level_t level, const
  * @param ...: Format arguments
  */
 void elog_message(elog_module_t module, elog_level_t level, const char *fmt, ...);
-#define LOG_MESSAGE(module, level, ...) elog_message(module, level, __VA_ARGS__)
+#define LOG_MESSAGE(module, level, ...) do { \
+    if (ELOG_LEVEL_ENABLED(module, level)) { \
+      ELOG_SITE_PASS(module, level) \
+      elog_message(module, level, __VA_ARGS__); \
+    } \
+} while(0)
+#endif
+
+/**
+ * @brief Log a buffer as a single record
+ * @note  Text subscribers get a "hexdump N bytes:" line followed by ELOG_HEXDUMP_BYTES_PER_LINE bytes
+ *        per line ("0010: 0A 1B ..."), cut with "... N more bytes" when the message buffer is full.
+ *        Binary sinks (elog_bin_encode_record) store the bytes unchanged as ELOG_BIN_PAYLOAD_RAW.
+ * @param module: Module identifier
+ * @param level: Severity level
+ * @param data: Buffer to dump (must stay valid for the duration of the call)
+ * @param len: Number of bytes
+ */
+void elog_hexdump(elog_module_t module, elog_level_t level, const void *data, size_t len);
+#define ELOG_HEXDUMP(module, level, ptr, len) do { \
+    if (ELOG_LEVEL_ENABLED(module, level)) { \
+      ELOG_SITE_PASS(module, level) \
+      elog_hexdump(module, level, ptr, len); \
+    } \
+} while(0)
+
+/**
+ * @brief Log an event with typed fields as a single record
+ * @note  Text subscribers get "<event> key=value key=value ..." (strings containing spaces are quoted);
+ *        binary sinks (elog_bin_encode_record) get the fields varint-encoded as ELOG_BIN_PAYLOAD_KV
+ *        and the text is never produced.
+ * @param module: Module identifier
+ * @param level: Severity level
+ * @param event: Event name (printed verbatim, not a format string)
+ * @param fields: Field array
+ * @param count: Number of fields (ELOG_KV also accepts none: the record is the bare event name)
+ */
+void elog_kv(elog_module_t module, elog_level_t level, const char *event, const elog_kv_t *fields, size_t count);
+#define ELOG_KV(module, level, event, ...) do { \
+    if (ELOG_LEVEL_ENABLED(module, level)) { \
+      ELOG_SITE_PASS(module, level) \
+      const elog_kv_t elog_kv_fields_[] = {{.key = NULL}, __VA_ARGS__}; /* Leading sentinel: no fields is valid */ \
+      elog_kv(module, level, event, elog_kv_fields_ + 1, sizeof(elog_kv_fields_) / sizeof(elog_kv_fields_[0]) - 1u); \
+    } \
+} while(0)
+
+/* ========================================================================== */
+/* Trace Spans */
+/* ========================================================================== */
+
+#define ELOG_SPAN_PHASE_BEGIN 'B' /* Chrome trace event phases */
+#define ELOG_SPAN_PHASE_END   'E'
+
+/**
+ * @brief Open span, normally declared by ELOG_SPAN_BEGIN / ELOG_SPAN_SCOPE
+ */
+typedef struct {
+  const char *name;
+  elog_module_t module;
+  uint32_t start;   /*!< Timestamp ticks at begin */
+  bool active;      /*!< Begin was logged, so end will be */
+} elog_span_t;
+
+/**
+ * @brief Log a span begin event (ELOG_SPAN_LEVEL) and remember its start time
+ * @note  Text subscribers get "> <name>", binary sinks a compact ELOG_BIN_PAYLOAD_SPAN frame.
+ * @param span: Span state, passed to elog_span_end()
+ * @param module: Module identifier
+ * @param name: Span name (static string, printed verbatim)
+ */
+void elog_span_begin(elog_span_t *span, elog_module_t module, const char *name);
+
+/**
+ * @brief Log the end event of a span whose begin was logged
+ * @note  Text subscribers get "< <name> <N> us" (ticks when the timestamp rate is unknown).
+ * @param span: Span state from elog_span_begin()
+ */
+void elog_span_end(elog_span_t *span);
+
+#define ELOG_SPAN_BEGIN(var, module, name) \
+  elog_span_t var = {NULL, (module), 0u, false}; \
+  if (ELOG_LEVEL_ENABLED(module, ELOG_SPAN_LEVEL)) { elog_span_begin(&var, module, name); }
+#define ELOG_SPAN_END(var) do { \
+    if ((var).active) { elog_span_end(&(var)); } \
+} while(0)
+
+/* Span ending when the enclosing block is left (return, break, goto included) */
+#define ELOG_SPAN_CONCAT_(a, b) a##b
+#define ELOG_SPAN_VAR_(line) ELOG_SPAN_CONCAT_(elog_span_, line)
+#define ELOG_SPAN_SCOPE(module, name) \
+  elog_span_t ELOG_SPAN_VAR_(__LINE__) __attribute__((cleanup(elog_span_end))) = {NULL, (module), 0u, false}; \
+  if (ELOG_LEVEL_ENABLED(module, ELOG_SPAN_LEVEL)) { elog_span_begin(&ELOG_SPAN_VAR_(__LINE__), module, name); }
+
+/* ========================================================================== */
+/* ISR Fast Path */
+/* ========================================================================== */
+
+/**
+ * @brief Format and deliver records captured in interrupt context (ELOG_ISR_ENABLE = YES)
+ * @note  Call from a task: the idle hook, a low-priority log task, or the main loop on bare metal.
+ *        Records keep their capture timestamp; sequence numbers are assigned here, and they are
+ *        delivered with fmt "%s" and the expanded message as the only argument. %s arguments
+ *        logged from an ISR are read here, so they must point to constant or static strings.
+ * @param max_records: Upper bound on records delivered by this call, 0 for all pending
+ * @return Number of records delivered
+ */
+uint32_t elog_isr_drain(uint32_t max_records);
+
+/**
+ * @brief Number of captured records waiting for elog_isr_drain()
+ */
+uint32_t elog_isr_pending(void);
+
+/* ========================================================================== */
+/* Timestamps */
+/* ========================================================================== */
+
+/**
+ * @brief Register the timestamp source sampled at elog_message entry
+ * @note  While a source is set, the text prefix becomes "<level>:<module>,<nbr>@<ticks>:".
+ * @param fn: Tick source, or NULL to disable timestamps
+ * @param ticks_per_sec: Source rate, recorded for decoders (e.g. core clock for a cycle counter)
+ */
+void elog_set_timestamp_source(elog_timestamp_fn_t fn, uint32_t ticks_per_sec);
+
+/**
+ * @brief Get the rate of the registered timestamp source
+ * @return Ticks per second, or 0 when no source is registered
+ */
+uint32_t elog_get_timestamp_rate(void);
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+/**
+ * @brief Enable the DWT cycle counter and use it as the timestamp source
+ * @param core_hz: Core clock frequency
+ */
+void elog_timestamp_use_cycle_counter(uint32_t core_hz);
+#elif defined(__unix__) || defined(__APPLE__)
+/**
+ * @brief Use CLOCK_MONOTONIC in microseconds as the timestamp source (host builds)
+ */
+void elog_timestamp_use_monotonic_clock(void);
+#endif
+
+/* ========================================================================== */
+/* Binary Frames (eLog_bin.c) */
+/* ========================================================================== */
+
+/* Frame layout (all integers LEB128 varints):
+ *   [hdr] [module] [sequence] [global_sequence] [timestamp]? [sample_rate]? [payload_len] [payload...]
+ *   hdr bits 0-2: level - ELOG_LEVEL_TRACE, bits 3-4: payload type, bit 5: sample rate present
+ *   (sampled record, see elog_set_module_sampling), bit 6: timestamp present,
+ *   bit 7: sync frame - global sequence and timestamp are absolute, otherwise both are
+ *          deltas to the previous frame of the stream */
+#define ELOG_BIN_HDR_LEVEL_MASK    0x07u
+#define ELOG_BIN_HDR_TYPE_SHIFT    3u
+#define ELOG_BIN_HDR_TYPE_MASK     0x18u
+#define ELOG_BIN_HDR_SAMPLED       0x20u
+#define ELOG_BIN_HDR_TIMESTAMP     0x40u
+#define ELOG_BIN_HDR_SYNC          0x80u
+
+/* Payload types */
+#define ELOG_BIN_PAYLOAD_TEXT      0u  /*!< User message text (no prefix, color or newline) */
+#define ELOG_BIN_PAYLOAD_RAW       1u  /*!< Raw bytes of an ELOG_HEXDUMP record */
+#define ELOG_BIN_PAYLOAD_KV        2u  /*!< ELOG_KV event and fields, see elog_bin_kv_open() */
+#define ELOG_BIN_PAYLOAD_SPAN      3u  /*!< ELOG_SPAN_* event, see elog_bin_span_open() */
+
+/* Largest frame header: hdr + module + five 5-byte varints */
+#define ELOG_BIN_HEADER_MAX        27u
+
+/**
+ * @brief Per-stream delta-encoding state (one per sink / per decoder)
+ */
+typedef struct {
+  uint32_t last_global_sequence;
+  uint32_t last_timestamp;
+  bool synced;             /*!< false: next frame is a sync frame */
+  bool timestamped;        /*!< Previous frame carried a timestamp */
+} elog_bin_state_t;
+
+/**
+ * @brief Decoded binary frame
+ */
+typedef struct {
+  elog_module_t module;
+  elog_level_t level;
+  uint8_t payload_type;
+  bool has_timestamp;
+  uint32_t sequence;
+  uint32_t global_sequence; /*!< Absolute (deltas already applied) */
+  uint32_t timestamp;      /*!< Absolute ticks (deltas already applied) */
+  uint32_t sample_rate;    /*!< 1 in sample_rate records was kept (1 = not sampled) */
+  const uint8_t *payload;  /*!< Points into the decoded buffer */
+  size_t payload_len;
+} elog_bin_frame_t;
+
+/**
+ * @brief Reset a stream so its next frame is a sync frame
+ * @param state: Stream state
+ */
+void elog_bin_reset(elog_bin_state_t *state);
+
+/**
+ * @brief Encode a frame with an arbitrary payload
+ * @param state: Stream state (updated only on success)
+ * @param rec: Record providing module, level, sequence and timestamp
+ * @param payload_type: ELOG_BIN_PAYLOAD_*
+ * @param payload: Payload bytes
+ * @param payload_len: Payload length
+ * @param out: Destination buffer
+ * @param size: Size of out
+ * @return Frame length, or 0 if it does not fit
+ */
+size_t elog_bin_encode(elog_bin_state_t *state, const elog_record_t *rec, uint8_t payload_type,
+                       const void *payload, size_t payload_len, uint8_t *out, size_t size);
+
+/**
+ * @brief Encode a record with its user message as a text payload (raw bytes for ELOG_HEXDUMP records,
+ *        encoded fields for ELOG_KV records)
+ * @return Frame length, or 0 if it does not fit
+ */
+size_t elog_bin_encode_record(elog_bin_state_t *state, const elog_record_t *rec, uint8_t *out, size_t size);
+
+/**
+ * @brief Decode one frame
+ * @param state: Decoder stream state
+ * @param buf: Input bytes
+ * @param len: Number of input bytes
+ * @param frame: Receives the decoded frame
+ * @return Bytes consumed, 0 if the frame is incomplete, -1 if it is malformed
+ */
+int elog_bin_decode(elog_bin_state_t *state, const uint8_t *buf, size_t len, elog_bin_frame_t *frame);
+
+/* ELOG_BIN_PAYLOAD_KV layout:
+ *   [event_len] [event...] then per field: [type] [key_len] [key...] [value]
+ *   value: U32/U64/X32 varint, I32/I64 zigzag varint, BOOL one byte, F32 4 bytes little-endian,
+ *          STR [len] [bytes...] */
+
+/**
+ * @brief Cursor over the fields of a decoded ELOG_BIN_PAYLOAD_KV frame
+ */
+typedef struct {
+  const uint8_t *pos;
+  const uint8_t *end;
+} elog_kv_reader_t;
+
+/**
+ * @brief Decoded field (key and string values point into the frame, not NUL-terminated)
+ */
+typedef struct {
+  uint8_t type;          /*!< elog_kv_type_t */
+  const char *key;
+  uint32_t key_len;
+  union {
+    uint64_t u;          /*!< U32, U64, X32 */
+    int64_t i;           /*!< I32, I64 */
+    bool b;
+    float f32;
+  } v;
+  const char *str;       /*!< STR value */
+  uint32_t str_len;
+} elog_kv_field_t;
+
+/**
+ * @brief Start reading an ELOG_BIN_PAYLOAD_KV frame
+ * @param reader: Cursor to initialize
+ * @param frame: Decoded frame
+ * @param event: Receives the event name (not NUL-terminated)
+ * @param event_len: Receives the event name length
+ * @return 0 on success, -1 if the frame is not a well-formed KV frame
+ */
+int elog_bin_kv_open(elog_kv_reader_t *reader, const elog_bin_frame_t *frame, const char **event, uint32_t *event_len);
+
+/**
+ * @brief Read the next field
+ * @param reader: Cursor from elog_bin_kv_open()
+ * @param field: Receives the field
+ * @return 1 if a field was read, 0 at the end, -1 if malformed
+ */
+int elog_bin_kv_next(elog_kv_reader_t *reader, elog_kv_field_t *field);
+
+/* ELOG_BIN_PAYLOAD_SPAN layout: [phase 'B'/'E'] [span_ticks varint] [name...] */
+
+/**
+ * @brief Read a decoded ELOG_BIN_PAYLOAD_SPAN frame
+ * @param frame: Decoded frame
+ * @param phase: Receives ELOG_SPAN_PHASE_BEGIN or ELOG_SPAN_PHASE_END
+ * @param span_ticks: Receives the duration in ticks (end events, 0 for begin)
+ * @param name: Receives the span name (not NUL-terminated)
+ * @param name_len: Receives the name length
+ * @return 0 on success, -1 if the frame is not a well-formed span frame
+ */
+int elog_bin_span_open(const elog_bin_frame_t *frame, uint8_t *phase, uint32_t *span_ticks, const char **name,
+                       uint32_t *name_len);
+
+/* ========================================================================== */
+/* Chrome Trace Export (eLog_trace.c) */
+/* ========================================================================== */
+
+/**
+ * @brief Converter state: widens 32-bit frame timestamps into a 64-bit timeline
+ */
+typedef struct {
+  uint32_t ts_rate;   /*!< Timestamp ticks per second of the capturing target */
+  uint32_t last_ts;
+  uint64_t wraps;     /*!< Ticks added by timestamp wrap-arounds */
+  bool started;
+} elog_trace_json_t;
+
+/**
+ * @brief Start a conversion
+ * @param tj: Converter state
+ * @param ts_rate: Timestamp ticks per second (elog_get_timestamp_rate() on the target)
+ */
+void elog_trace_json_init(elog_trace_json_t *tj, uint32_t ts_rate);
+
+/**
+ * @brief Render one decoded frame as a Chrome trace event object (chrome://tracing, ui.perfetto.dev)
+ * @note  Span frames become "B"/"E" events, text frames instant "i" events; one thread per module.
+ *        Wrap the events in "[" ... "]" separated by commas (trailing "]" is optional for the viewers).
+ * @param tj: Converter state
+ * @param frame: Frame from elog_bin_decode(), with a timestamp
+ * @param out: Destination
+ * @param size: Destination size
+ * @return Length written, 0 if the frame has no trace representation, -1 if out is too small
+ */
+int elog_trace_json_event(elog_trace_json_t *tj, const elog_bin_frame_t *frame, char *out, size_t size);
+
+/**
+ * @brief Render the metadata event naming a module's track
+ * @param module: Module identifier
+ * @param out: Destination
+ * @param size: Destination size
+ * @return Length written, -1 if out is too small
+ */
+int elog_trace_json_module(elog_module_t module, char *out, size_t size);
+
+/* ========================================================================== */
+/* Crash-Persistent Ring (eLog_persist.c) */
+/* ========================================================================== */
+
+/* Placement for the persistent region on target; the linker script must map .noinit as NOLOAD */
+#ifndef ELOG_PERSIST_NOINIT
+#define ELOG_PERSIST_NOINIT __attribute__((section(".noinit")))
+#endif
+
+/**
+ * @brief Callback receiving recovered frames
+ * @param frame: Decoded frame (payload valid during the call)
+ * @param ctx: User context
+ */
+typedef void (*elog_persist_visit_t)(const elog_bin_frame_t *frame, void *ctx);
+
+/**
+ * @brief Attach the persistent region, keeping its contents if the magic/CRC header is intact
+ * @param region: Region surviving reset (ELOG_PERSIST_NOINIT buffer or mmap'd file)
+ * @param region_size: Size of the region in bytes
+ * @return ELOG_ERR_NONE, or ELOG_ERR_INVALID_PARAM if the region is too small
+ */
+elog_err_t elog_persist_init(void *region, size_t region_size);
+
+/**
+ * @brief Record subscriber storing binary frames in the persistent ring (evicts oldest)
+ * @note  Encodes in place in the ring's free span; a frame wrapping the end of the ring needs
+ *        ELOG_BIN_HEADER_MAX + ELOG_FULL_MESSAGE_LENGTH + 2 bytes of stack.
+ * @param rec: Record to store
+ * @return Always 0
+ */
+int elog_persist_subscriber(const elog_record_t *rec);
+
+/**
+ * @brief Number of frame bytes held in the persistent ring
+ * @return Bytes, 0 when empty
+ */
+uint32_t elog_persist_pending(void);
+
+/**
+ * @brief Hand every stored frame to fn, oldest first, and empty the ring
+ * @param fn: Called for each frame
+ * @param ctx: Passed through to fn
+ * @return Number of frames delivered
+ */
+uint32_t elog_persist_recover(elog_persist_visit_t fn, void *ctx);
+
+/* ========================================================================== */
+/* Priority Log Queue (eLog_queue.c) */
+/* ========================================================================== */
+
+/* Level bands: lane 0 holds ELOG_QUEUE_HIGH_LEVEL and above, lane 1 ELOG_QUEUE_MID_LEVEL and
+ * above, lane 2 everything else */
+#define ELOG_QUEUE_LANES 3u
+#ifndef ELOG_QUEUE_HIGH_LEVEL
+#define ELOG_QUEUE_HIGH_LEVEL ELOG_LEVEL_CRITICAL
+#endif
+#ifndef ELOG_QUEUE_MID_LEVEL
+#define ELOG_QUEUE_MID_LEVEL ELOG_LEVEL_WARNING
+#endif
+
+/* Queue counters, indexed by lane */
+typedef struct {
+  uint32_t queued[ELOG_QUEUE_LANES];     /*!< Lines accepted */
+  uint32_t dropped[ELOG_QUEUE_LANES];    /*!< Lines rejected because their lane was full */
+  uint32_t delivered[ELOG_QUEUE_LANES];  /*!< Lines taken by the output */
+  uint32_t high_water[ELOG_QUEUE_LANES]; /*!< Most bytes ever held */
+  uint32_t busy;                         /*!< Drains stopped by a busy output */
+} elog_queue_stats_t;
+
+/**
+ * @brief Carve the lanes out of one storage block
+ * @param storage: Lane storage, at least the sum of lane_bytes, must outlive the queue
+ * @param lane_bytes: Reserved bytes per lane, highest priority first (0 drops the band)
+ * @return ELOG_ERR_NONE, or ELOG_ERR_INVALID_PARAM
+ */
+elog_err_t elog_queue_init(uint8_t *storage, const uint32_t lane_bytes[ELOG_QUEUE_LANES]);
+
+/**
+ * @brief Record subscriber queueing the text line in the lane of its level (drops if that lane is full)
+ * @param rec: Record to queue
+ * @return 0 if queued, -1 if dropped
+ */
+int elog_queue_subscriber(const elog_record_t *rec);
+
+/**
+ * @brief Hand queued lines to an output from the log task, highest lane first
+ * @param out: Output taking one line per call (e.g. elog_console_subscriber); < 0 = busy, retry later
+ * @param max_records: Upper bound on lines written by this call, 0 for all
+ * @return Number of lines written
+ */
+uint32_t elog_queue_drain(log_subscriber_t out, uint32_t max_records);
+
+/**
+ * @brief Bytes queued in one lane
+ * @param lane: 0 (highest priority) to ELOG_QUEUE_LANES - 1
+ * @return Bytes, 0 when empty
+ */
+uint32_t elog_queue_pending(uint32_t lane);
+
+/**
+ * @brief Snapshot the per-lane counters
+ * @param stats: Output
+ */
+void elog_queue_get_stats(elog_queue_stats_t *stats);
+
+#if defined(__unix__) || defined(__APPLE__)
+/* ========================================================================== */
+/* Rotating File Subscriber (eLog_file.c, Linux/POSIX builds) */
+/* ========================================================================== */
+
+#ifndef ELOG_FILE_BUFFER_SIZE
+#define ELOG_FILE_BUFFER_SIZE (1024u * 1024u) /* Ring between loggers and the writer thread */
+#endif
+#ifndef ELOG_FILE_CHUNK_SIZE
+#define ELOG_FILE_CHUNK_SIZE (64u * 1024u)    /* Writer wakes and writes in chunks of this size */
 #endif
+#ifndef ELOG_FILE_FLUSH_MS
+#define ELOG_FILE_FLUSH_MS 200u               /* Partial chunks are written at least this often */
+#endif
+
+/**
+ * @brief File subscriber configuration (zero fields take the defaults above)
+ */
+typedef struct {
+  const char *path;           /*!< Active log file; rotated files get .1, .2, ... */
+  size_t max_bytes;           /*!< Rotate when the file would exceed this size (0 = never) */
+  unsigned max_files;         /*!< Files kept including the active one (< 2 = no rotation) */
+  size_t buffer_size;
+  size_t chunk_size;
+  uint32_t flush_interval_ms;
+} elog_file_config_t;
+
+/**
+ * @brief File subscriber counters
+ */
+typedef struct {
+  uint64_t bytes_written;
+  uint32_t dropped;           /*!< Lines dropped because the buffer was full */
+  uint32_t rotations;
+  uint32_t write_errors;
+} elog_file_stats_t;
+
+/**
+ * @brief Open the log file and start the writer thread
+ * @param cfg: Configuration
+ * @return Error code
+ */
+elog_err_t elog_file_open(const elog_file_config_t *cfg);
+
+/**
+ * @brief Text subscriber buffering lines for the writer thread (never blocks on I/O)
+ * @param handle: Unused
+ * @param buf: Message buffer
+ * @param len: Length of message
+ * @return Always 0
+ */
+int elog_file_subscriber(int handle, const char *buf, size_t len);
+
+/**
+ * @brief Write out everything buffered so far and wait for it
+ */
+void elog_file_flush(void);
+
+/**
+ * @brief Drain the buffer, stop the writer thread and close the file
+ * @note  Safe against concurrent elog_file_subscriber() calls: lines logged from here on are ignored.
+ */
+void elog_file_close(void);
+
+/**
+ * @brief Get a copy of the file subscriber counters
+ * @param stats: Destination
+ */
+void elog_file_get_stats(elog_file_stats_t *stats);
+
+/* ========================================================================== */
+/* Memory-Mapped File Subscriber (eLog_mmap.c, Linux/POSIX builds) */
+/* ========================================================================== */
+
+#ifndef ELOG_MMAP_CHUNK_SIZE
+#define ELOG_MMAP_CHUNK_SIZE (4u * 1024u * 1024u) /* File growth / mapping step */
+#endif
+
+/**
+ * @brief Create (truncate) the log file and reserve address space for max_bytes
+ * @param path: Log file path
+ * @param max_bytes: Largest file size
+ * @param chunk_bytes: Growth step (0 = ELOG_MMAP_CHUNK_SIZE)
+ * @return Error code
+ */
+elog_err_t elog_mmap_open(const char *path, size_t max_bytes, size_t chunk_bytes);
+
+/**
+ * @brief Text subscriber: atomic offset reservation + memcpy into the mapping
+ * @param handle: Unused
+ * @param buf: Message buffer
+ * @param len: Length of message
+ * @return Always 0
+ */
+int elog_mmap_subscriber(int handle, const char *buf, size_t len);
+
+/**
+ * @brief Start writeback of the mapped pages (only needed for power-loss durability)
+ */
+void elog_mmap_sync(void);
+
+/**
+ * @brief Number of bytes logged so far, dropped lines excluded (the file length after elog_mmap_close())
+ */
+size_t elog_mmap_size(void);
+
+/**
+ * @brief Number of lines dropped because the file was full or could not grow
+ * @note  Once the file fails to grow it ends before the failed line, and every later line is dropped.
+ */
+size_t elog_mmap_dropped(void);
+
+/**
+ * @brief Unmap, trim the preallocated tail and close the file (unsubscribe first)
+ */
+void elog_mmap_close(void);
+#endif
+
+/**
+ * @brief Format into buf with the built-in eLog printf engine (vsnprintf-compatible subset)
+ * @param buf: Destination buffer
+ * @param size: Size of buf including the terminator
+ * @param fmt: Printf-style format string (%d %i %u %x %X %o %c %s %p %f %%)
+ * @param args: Format arguments
+ * @return Number of characters that would have been written without truncation
+ */
+int elog_vsnprintf(char *buf, size_t size, const char *fmt, va_list args);
+
+/**
+ * @brief Format into buf with the built-in eLog printf engine
+ * @param buf: Destination buffer
+ * @param size: Size of buf including the terminator
+ * @param fmt: Printf-style format string
+ * @param ...: Format arguments
+ * @return Number of characters that would have been written without truncation
+ */
+int elog_snprintf(char *buf, size_t size, const char *fmt, ...);
+
+/**
+ * @brief Hash the argument values a format string would consume, without formatting
+ * @param fmt: Printf-style format string
+ * @param args: Format arguments
+ * @return Hash of the values (strings by content)
+ */
+uint32_t elog_fmt_hash_args(const char *fmt, va_list args);
+
+/**
+ * @brief Argument value captured for deferred formatting (see elog_fmt_pack_args)
+ */
+typedef union {
+  int64_t i;       /*!< %d %i %c, '*' width and precision */
+  uint64_t u;      /*!< %u %x %X %o */
+  double f;        /*!< %f %e %g */
+  const void *p;   /*!< %s %p (pointer only, strings are not copied) */
+} elog_arg_t;
+
+/**
+ * @brief Capture the values a format string would consume into fixed-size slots
+ * @param fmt: Printf-style format string
+ * @param args: Format arguments
+ * @param slots: Destination
+ * @param max: Number of slots available
+ * @return Number of slots the format needs; more than max means the values did not fit
+ */
+size_t elog_fmt_pack_args(const char *fmt, va_list args, elog_arg_t *slots, size_t max);
+
+/**
+ * @brief Encode bytes as uppercase hex (nibble lookup table, SSE2 on hosts that have it)
+ * @param out: Destination, at least len * 3 characters (len * 2 without separator); not terminated
+ * @param data: Bytes to encode
+ * @param len: Number of bytes
+ * @param sep: Separator between bytes, or '\0' for none
+ * @return Number of characters written (no trailing separator)
+ */
+size_t elog_hex_encode(char *out, const void *data, size_t len, char sep);
 
 /* ========================================================================== */
 #define LOG_SUBSCRIBE_THREAD_SAFE(fn, level) elog_subscribe(fn, level)
+#define LOG_SUBSCRIBE_MODULES(fn, level, module_mask) elog_subscribe_ex(fn, level, module_mask)
 #define LOG_UNSUBSCRIBE_THREAD_SAFE(fn) elog_unsubscribe(fn)
+#define LOG_SUBSCRIBE_RECORD(fn, level) elog_subscribe_record(fn, level, ELOG_MODULE_MASK_ALL)
+#define LOG_UNSUBSCRIBE_RECORD(fn) elog_unsubscribe_record(fn)
 
 /* Enhanced logging core macros */
 #define LOG_INIT() elog_init()
@@ -359,6 +1457,14 @@ void elog_message(elog_module_t module, elog_level_t level, const char *fmt, ...
 
 /* Convenience setup macro with console subscriber */
 extern int elog_console_subscriber(int handle, const char *buf, size_t len);
+#if ELOG_CONSOLE_RING_TX
+struct ring_tx;
+/**
+ * @brief Route elog_console_subscriber output into a ring_tx transmitter
+ * @param tx: Initialized transmitter (ring_tx_init), NULL to detach
+ */
+extern void elog_console_attach(struct ring_tx *tx);
+#endif
 #define LOG_INIT_WITH_CONSOLE() do { \
     LOG_INIT(); \
     LOG_SUBSCRIBE(elog_console_subscriber, ELOG_DEFAULT_THRESHOLD); \
@@ -381,15 +1487,15 @@ extern int elog_console_subscriber(int handle, const char *buf, size_t len);
 /* Individual level macros - follow same pattern as legacy debug macros */
 #if (ELOG_DEBUG_TRACE_ON == YES)
 #if ENABLE_DEBUG_MESSAGES_WITH_LOCATION
-#define ELOG_TRACE(...) LOG_MESSAGE_WITH_LOCATION(ELOG_LEVEL_TRACE, debug_get_filename(__ASSERT_FILE_NAME), __func__, __LINE__, __VA_ARGS__)
-#define ELOG_TRACE_STR(str) LOG_MESSAGE_WITH_LOCATION(ELOG_LEVEL_TRACE, debug_get_filename(__ASSERT_FILE_NAME), __func__, __LINE__, "%s", str)
+#define ELOG_TRACE(module, ...) LOG_MESSAGE_WITH_LOCATION(module, ELOG_LEVEL_TRACE, debug_get_filename(__ASSERT_FILE_NAME), __func__, __LINE__, __VA_ARGS__)
+#define ELOG_TRACE_STR(module, str) LOG_MESSAGE_WITH_LOCATION(module, ELOG_LEVEL_TRACE, debug_get_filename(__ASSERT_FILE_NAME), __func__, __LINE__, "%s", str)
 #else
-#define ELOG_TRACE(...) LOG_MESSAGE(ELOG_LEVEL_TRACE, __VA_ARGS__)
-#define ELOG_TRACE_STR(str) LOG_MESSAGE(ELOG_LEVEL_TRACE, "%s", str)
+#define ELOG_TRACE(module, ...) LOG_MESSAGE(module, ELOG_LEVEL_TRACE, __VA_ARGS__)
+#define ELOG_TRACE_STR(module, str) LOG_MESSAGE(module, ELOG_LEVEL_TRACE, "%s", str)
 #endif
 #else
-#define ELOG_TRACE(...) do {} while(0)
-#define ELOG_TRACE_STR(str) do {} while(0)
+#define ELOG_TRACE(module, ...) do {} while(0)
+#define ELOG_TRACE_STR(module, str) do {} while(0)
 #endif
 
 #if (ELOG_DEBUG_LOG_ON == YES)
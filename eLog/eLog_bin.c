@@ -0,0 +1,459 @@
+/***********************************************************
+ * @file	eLog_bin.c
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Compact binary frame encoder/decoder for eLog records
+ *         Frames carry level, module, sequences and a delta-encoded
+ *         timestamp as LEB128 varints, so a record costs a few header
+ *         bytes instead of a text prefix. See eLog.h for the layout.
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+
+#include "eLog.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* ========================================================================== */
+/* Varint Helpers */
+/* ========================================================================== */
+
+/**
+ * @brief Write v as an unsigned LEB128 varint
+ * @return Number of bytes written (1..5)
+ */
+static inline size_t elog_bin_put_varint(uint8_t *out, uint32_t v)
+{
+  size_t n = 0;
+  while (v >= 0x80u)
+  {
+    out[n++] = (uint8_t)(v | 0x80u);
+    v >>= 7;
+  }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+/**
+ * @brief Read an unsigned LEB128 varint
+ * @return Number of bytes consumed, 0 if incomplete, -1 if longer than 5 bytes
+ */
+static inline int elog_bin_get_varint(const uint8_t *buf, size_t len, uint32_t *v)
+{
+  uint32_t result = 0;
+  for (size_t i = 0; i < 5u; i++)
+  {
+    if (i >= len) { return 0; }
+    result |= (uint32_t)(buf[i] & 0x7Fu) << (7u * i);
+    if (!(buf[i] & 0x80u))
+    {
+      *v = result;
+      return (int)i + 1;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Write v as an unsigned LEB128 varint (64-bit values)
+ * @return Number of bytes written (1..10)
+ */
+static inline size_t elog_bin_put_varint64(uint8_t *out, uint64_t v)
+{
+  size_t n = 0;
+  while (v >= 0x80u)
+  {
+    out[n++] = (uint8_t)(v | 0x80u);
+    v >>= 7;
+  }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+/**
+ * @brief Read an unsigned LEB128 varint (64-bit values)
+ * @return Number of bytes consumed, 0 if incomplete, -1 if longer than 10 bytes
+ */
+static inline int elog_bin_get_varint64(const uint8_t *buf, size_t len, uint64_t *v)
+{
+  uint64_t result = 0;
+  for (size_t i = 0; i < 10u; i++)
+  {
+    if (i >= len) { return 0; }
+    result |= (uint64_t)(buf[i] & 0x7Fu) << (7u * i);
+    if (!(buf[i] & 0x80u))
+    {
+      *v = result;
+      return (int)i + 1;
+    }
+  }
+  return -1;
+}
+
+/* Signed values as zigzag varints: small magnitudes of either sign stay short */
+static inline uint64_t elog_bin_zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static inline int64_t elog_bin_unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1u); }
+
+/* ========================================================================== */
+/* Encoder */
+/* ========================================================================== */
+
+/**
+ * @brief Reset a stream so its next frame is a sync frame
+ * @param state: Stream state
+ */
+void elog_bin_reset(elog_bin_state_t *state)
+{
+  state->last_global_sequence = 0;
+  state->last_timestamp = 0;
+  state->synced = false;
+  state->timestamped = false;
+}
+
+/**
+ * @brief Encode a frame with an arbitrary payload
+ * @param state: Stream state (updated only on success)
+ * @param rec: Record providing module, level, sequence and timestamp
+ * @param payload_type: ELOG_BIN_PAYLOAD_*
+ * @param payload: Payload bytes (may be staged in place at out + ELOG_BIN_HEADER_MAX)
+ * @param payload_len: Payload length
+ * @param out: Destination buffer
+ * @param size: Size of out
+ * @return Frame length, or 0 if it does not fit
+ */
+size_t elog_bin_encode(elog_bin_state_t *state, const elog_record_t *rec, uint8_t payload_type,
+                       const void *payload, size_t payload_len, uint8_t *out, size_t size)
+{
+  uint8_t hdr[ELOG_BIN_HEADER_MAX];
+  size_t n = 2;
+
+  hdr[0] = (uint8_t)(((unsigned)(rec->level - ELOG_LEVEL_TRACE) & ELOG_BIN_HDR_LEVEL_MASK) |
+                     (((unsigned)payload_type << ELOG_BIN_HDR_TYPE_SHIFT) & ELOG_BIN_HDR_TYPE_MASK));
+  hdr[1] = (uint8_t)rec->module;
+  n += elog_bin_put_varint(&hdr[n], rec->sequence);
+
+  /* Resync when the stream starts or the timestamp source comes or goes */
+  const bool sync = !state->synced || (state->timestamped != rec->has_timestamp);
+  if (sync)
+  {
+    hdr[0] |= ELOG_BIN_HDR_SYNC;
+    n += elog_bin_put_varint(&hdr[n], rec->global_sequence);
+  }
+  else
+  {
+    /* Unsigned differences are correct across counter wrap */
+    n += elog_bin_put_varint(&hdr[n], rec->global_sequence - state->last_global_sequence);
+  }
+  if (rec->has_timestamp)
+  {
+    hdr[0] |= ELOG_BIN_HDR_TIMESTAMP;
+    n += elog_bin_put_varint(&hdr[n], sync ? rec->timestamp : rec->timestamp - state->last_timestamp);
+  }
+  if (rec->sample_rate > 1u)
+  {
+    hdr[0] |= ELOG_BIN_HDR_SAMPLED;
+    n += elog_bin_put_varint(&hdr[n], rec->sample_rate);
+  }
+  n += elog_bin_put_varint(&hdr[n], (uint32_t)payload_len);
+
+  if (n + payload_len > size) { return 0; }
+  memcpy(out, hdr, n);
+  if (payload_len != 0) { memmove(out + n, payload, payload_len); } /* payload may be staged inside out */
+
+  state->last_global_sequence = rec->global_sequence;
+  state->last_timestamp = rec->timestamp;
+  state->timestamped = rec->has_timestamp;
+  state->synced = true;
+  return n + payload_len;
+}
+
+/**
+ * @brief Append a length-prefixed string
+ * @return Bytes written, 0 if it does not fit
+ */
+static size_t elog_bin_put_str(uint8_t *out, size_t room, const char *str, size_t len)
+{
+  if (len > UINT32_MAX || 5u + len > room) { return 0; }
+  size_t n = elog_bin_put_varint(out, (uint32_t)len);
+  memcpy(out + n, str, len);
+  return n + len;
+}
+
+/**
+ * @brief Encode the event name and fields of an ELOG_KV record (layout in eLog.h)
+ * @return Payload length, or 0 if it does not fit
+ */
+static size_t elog_bin_kv_payload(const elog_record_t *rec, uint8_t *out, size_t size)
+{
+  size_t pos = elog_bin_put_str(out, size, rec->fmt, strlen(rec->fmt));
+  if (pos == 0) { return 0; }
+
+  for (uint32_t i = 0; i < rec->field_count; i++)
+  {
+    const elog_kv_t *f = &rec->fields[i];
+    const char *key = (f->key != NULL) ? f->key : "";
+    size_t n;
+
+    if (pos + 1u > size) { return 0; }
+    out[pos++] = f->type;
+    if ((n = elog_bin_put_str(out + pos, size - pos, key, strlen(key))) == 0) { return 0; }
+    pos += n;
+
+    if (f->type == ELOG_KV_STR)
+    {
+      const char *str = (f->v.str != NULL) ? f->v.str : "";
+      if ((n = elog_bin_put_str(out + pos, size - pos, str, strlen(str))) == 0) { return 0; }
+      pos += n;
+      continue;
+    }
+    if (pos + 10u > size) { return 0; } /* longest scalar: 64-bit varint */
+    switch (f->type)
+    {
+    case ELOG_KV_U32:
+    case ELOG_KV_X32: pos += elog_bin_put_varint(out + pos, f->v.u32); break;
+    case ELOG_KV_I32: pos += elog_bin_put_varint64(out + pos, elog_bin_zigzag(f->v.i32)); break;
+    case ELOG_KV_U64: pos += elog_bin_put_varint64(out + pos, f->v.u64); break;
+    case ELOG_KV_I64: pos += elog_bin_put_varint64(out + pos, elog_bin_zigzag(f->v.i64)); break;
+    case ELOG_KV_BOOL: out[pos++] = f->v.b ? 1u : 0u; break;
+    case ELOG_KV_F32:
+    {
+      uint32_t bits;
+      memcpy(&bits, &f->v.f32, sizeof(bits));
+      out[pos++] = (uint8_t)bits;
+      out[pos++] = (uint8_t)(bits >> 8);
+      out[pos++] = (uint8_t)(bits >> 16);
+      out[pos++] = (uint8_t)(bits >> 24);
+      break;
+    }
+    default: return 0;
+    }
+  }
+  return pos;
+}
+
+/**
+ * @brief Encode the phase, duration and name of an ELOG_SPAN event (layout in eLog.h)
+ * @return Payload length, or 0 if it does not fit
+ */
+static size_t elog_bin_span_payload(const elog_record_t *rec, uint8_t *out, size_t size)
+{
+  size_t name_len = strlen(rec->fmt);
+  if (size < 1u + 5u + name_len) { return 0; }
+  out[0] = rec->span;
+  size_t pos = 1u + elog_bin_put_varint(out + 1, rec->span_ticks);
+  memcpy(out + pos, rec->fmt, name_len);
+  return pos + name_len;
+}
+
+/**
+ * @brief Encode a record with its user message as a text payload (ELOG_HEXDUMP records: raw bytes,
+ *        ELOG_KV records: varint-encoded fields, ELOG_SPAN events: phase, duration and name)
+ * @return Frame length, or 0 if it does not fit
+ */
+size_t elog_bin_encode_record(elog_bin_state_t *state, const elog_record_t *rec, uint8_t *out, size_t size)
+{
+  if (rec->span != 0u)
+  {
+    if (size <= ELOG_BIN_HEADER_MAX) { return 0; }
+    size_t len = elog_bin_span_payload(rec, out + ELOG_BIN_HEADER_MAX, size - ELOG_BIN_HEADER_MAX);
+    if (len == 0) { return 0; }
+    return elog_bin_encode(state, rec, ELOG_BIN_PAYLOAD_SPAN, out + ELOG_BIN_HEADER_MAX, len, out, size);
+  }
+  if (rec->fields != NULL)
+  {
+    /* Stage the payload where the frame body goes; elog_bin_encode moves it behind the header */
+    if (size <= ELOG_BIN_HEADER_MAX) { return 0; }
+    size_t len = elog_bin_kv_payload(rec, out + ELOG_BIN_HEADER_MAX, size - ELOG_BIN_HEADER_MAX);
+    if (len == 0) { return 0; }
+    return elog_bin_encode(state, rec, ELOG_BIN_PAYLOAD_KV, out + ELOG_BIN_HEADER_MAX, len, out, size);
+  }
+  if (rec->data != NULL)
+  {
+    /* Hexdumps keep their bytes; the text rendering is never produced */
+    return elog_bin_encode(state, rec, ELOG_BIN_PAYLOAD_RAW, rec->data, rec->data_len, out, size);
+  }
+  size_t len;
+  const char *msg = elog_record_message(rec, &len);
+  return elog_bin_encode(state, rec, ELOG_BIN_PAYLOAD_TEXT, msg, len, out, size);
+}
+
+/* ========================================================================== */
+/* Decoder */
+/* ========================================================================== */
+
+/**
+ * @brief Decode one frame
+ * @param state: Decoder stream state
+ * @param buf: Input bytes
+ * @param len: Number of input bytes
+ * @param frame: Receives the decoded frame
+ * @return Bytes consumed, 0 if the frame is incomplete, -1 if it is malformed
+ */
+int elog_bin_decode(elog_bin_state_t *state, const uint8_t *buf, size_t len, elog_bin_frame_t *frame)
+{
+  if (len < 2) { return 0; }
+
+  const uint8_t hdr = buf[0];
+  size_t pos = 2;
+  uint32_t v;
+  int r;
+
+  frame->level = (elog_level_t)(ELOG_LEVEL_TRACE + (hdr & ELOG_BIN_HDR_LEVEL_MASK));
+  frame->payload_type = (uint8_t)((hdr & ELOG_BIN_HDR_TYPE_MASK) >> ELOG_BIN_HDR_TYPE_SHIFT);
+  frame->module = (elog_module_t)buf[1];
+  if (frame->level > ELOG_LEVEL_ALWAYS) { return -1; }
+
+  if ((r = elog_bin_get_varint(buf + pos, len - pos, &frame->sequence)) <= 0) { return r; }
+  pos += (size_t)r;
+
+  const bool sync = (hdr & ELOG_BIN_HDR_SYNC) != 0;
+  if (!sync && !state->synced) { return -1; } /* Delta frame without a preceding sync frame */
+
+  if ((r = elog_bin_get_varint(buf + pos, len - pos, &v)) <= 0) { return r; }
+  pos += (size_t)r;
+  frame->global_sequence = sync ? v : state->last_global_sequence + v;
+
+  frame->has_timestamp = (hdr & ELOG_BIN_HDR_TIMESTAMP) != 0;
+  frame->timestamp = 0;
+  if (frame->has_timestamp)
+  {
+    if ((r = elog_bin_get_varint(buf + pos, len - pos, &v)) <= 0) { return r; }
+    pos += (size_t)r;
+    frame->timestamp = sync ? v : state->last_timestamp + v;
+  }
+
+  frame->sample_rate = 1;
+  if (hdr & ELOG_BIN_HDR_SAMPLED)
+  {
+    if ((r = elog_bin_get_varint(buf + pos, len - pos, &frame->sample_rate)) <= 0) { return r; }
+    pos += (size_t)r;
+  }
+
+  if ((r = elog_bin_get_varint(buf + pos, len - pos, &v)) <= 0) { return r; }
+  pos += (size_t)r;
+  if (v > len - pos) { return 0; }
+  frame->payload = buf + pos;
+  frame->payload_len = v;
+  pos += v;
+
+  state->last_global_sequence = frame->global_sequence;
+  state->last_timestamp = frame->timestamp;
+  state->timestamped = frame->has_timestamp;
+  state->synced = true;
+  return (int)pos;
+}
+
+/* ========================================================================== */
+/* Structured (KV) Payload Decoder */
+/* ========================================================================== */
+
+/**
+ * @brief Read a length-prefixed string at the reader position
+ * @return 0 on success, -1 if malformed
+ */
+static int elog_bin_kv_get_str(elog_kv_reader_t *reader, const char **str, uint32_t *len)
+{
+  uint32_t n;
+  int r = elog_bin_get_varint(reader->pos, (size_t)(reader->end - reader->pos), &n);
+  if (r <= 0) { return -1; }
+  reader->pos += r;
+  if (n > (size_t)(reader->end - reader->pos)) { return -1; }
+  *str = (const char *)reader->pos;
+  *len = n;
+  reader->pos += n;
+  return 0;
+}
+
+/**
+ * @brief Start reading an ELOG_BIN_PAYLOAD_KV frame
+ * @param reader: Cursor to initialize
+ * @param frame: Decoded frame
+ * @param event: Receives the event name (not NUL-terminated)
+ * @param event_len: Receives the event name length
+ * @return 0 on success, -1 if the frame is not a well-formed KV frame
+ */
+int elog_bin_kv_open(elog_kv_reader_t *reader, const elog_bin_frame_t *frame, const char **event, uint32_t *event_len)
+{
+  if (frame->payload_type != ELOG_BIN_PAYLOAD_KV) { return -1; }
+  reader->pos = frame->payload;
+  reader->end = frame->payload + frame->payload_len;
+  return elog_bin_kv_get_str(reader, event, event_len);
+}
+
+/**
+ * @brief Read the next field
+ * @param reader: Cursor from elog_bin_kv_open()
+ * @param field: Receives the field
+ * @return 1 if a field was read, 0 at the end, -1 if malformed
+ */
+int elog_bin_kv_next(elog_kv_reader_t *reader, elog_kv_field_t *field)
+{
+  if (reader->pos >= reader->end) { return 0; }
+  field->type = *reader->pos++;
+  field->str = NULL;
+  field->str_len = 0;
+  if (elog_bin_kv_get_str(reader, &field->key, &field->key_len) != 0) { return -1; }
+
+  const size_t left = (size_t)(reader->end - reader->pos);
+  uint64_t v;
+  int r;
+  switch (field->type)
+  {
+  case ELOG_KV_STR:
+    return (elog_bin_kv_get_str(reader, &field->str, &field->str_len) == 0) ? 1 : -1;
+  case ELOG_KV_U32:
+  case ELOG_KV_X32:
+  case ELOG_KV_U64:
+    if ((r = elog_bin_get_varint64(reader->pos, left, &v)) <= 0) { return -1; }
+    field->v.u = v;
+    break;
+  case ELOG_KV_I32:
+  case ELOG_KV_I64:
+    if ((r = elog_bin_get_varint64(reader->pos, left, &v)) <= 0) { return -1; }
+    field->v.i = elog_bin_unzigzag(v);
+    break;
+  case ELOG_KV_BOOL:
+    if (left < 1u) { return -1; }
+    field->v.b = reader->pos[0] != 0u;
+    r = 1;
+    break;
+  case ELOG_KV_F32:
+  {
+    if (left < 4u) { return -1; }
+    uint32_t bits = (uint32_t)reader->pos[0] | ((uint32_t)reader->pos[1] << 8) | ((uint32_t)reader->pos[2] << 16) |
+                    ((uint32_t)reader->pos[3] << 24);
+    memcpy(&field->v.f32, &bits, sizeof(bits));
+    r = 4;
+    break;
+  }
+  default:
+    return -1;
+  }
+  reader->pos += r;
+  return 1;
+}
+
+/**
+ * @brief Read a decoded ELOG_BIN_PAYLOAD_SPAN frame
+ * @param frame: Decoded frame
+ * @param phase: Receives ELOG_SPAN_PHASE_BEGIN or ELOG_SPAN_PHASE_END
+ * @param span_ticks: Receives the duration in ticks (end events, 0 for begin)
+ * @param name: Receives the span name (not NUL-terminated)
+ * @param name_len: Receives the name length
+ * @return 0 on success, -1 if the frame is not a well-formed span frame
+ */
+int elog_bin_span_open(const elog_bin_frame_t *frame, uint8_t *phase, uint32_t *span_ticks, const char **name,
+                       uint32_t *name_len)
+{
+  if (frame->payload_type != ELOG_BIN_PAYLOAD_SPAN || frame->payload_len < 2u) { return -1; }
+  if (frame->payload[0] != ELOG_SPAN_PHASE_BEGIN && frame->payload[0] != ELOG_SPAN_PHASE_END) { return -1; }
+  int r = elog_bin_get_varint(frame->payload + 1, frame->payload_len - 1u, span_ticks);
+  if (r <= 0) { return -1; }
+  *phase = frame->payload[0];
+  *name = (const char *)frame->payload + 1 + r;
+  *name_len = (uint32_t)(frame->payload_len - 1u - (size_t)r);
+  return 0;
+}
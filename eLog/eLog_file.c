@@ -0,0 +1,320 @@
+/***********************************************************
+ * @file	eLog_file.c
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Buffered, rotating file subscriber for Linux/POSIX builds
+ *         The subscriber only copies text into a byte ring_t; a writer
+ *         thread drains it in large aligned chunks with write(2) and
+ *         rotates <path> -> <path>.1 -> ... -> <path>.<max_files-1>
+ *         at a line boundary when the file reaches max_bytes.
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+
+#include "eLog.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include "ring.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ELOG_FILE_ALIGN 4096u
+
+/* Writer state; s_file.lock guards the ring and the flags */
+static struct
+{
+  elog_file_config_t cfg;
+  ring_t ring;
+  uint8_t *chunk;       /* Aligned staging buffer for write(2) */
+  int fd;
+  size_t file_bytes;    /* Bytes in the current file */
+  bool line_open;       /* The current file ends inside a line (a chunk split it) */
+  bool open;
+  bool stop;
+  bool flush_requested;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t data_ready;
+  pthread_cond_t drained;
+  elog_file_stats_t stats;
+} s_file = {.fd = -1, .lock = PTHREAD_MUTEX_INITIALIZER, .data_ready = PTHREAD_COND_INITIALIZER,
+            .drained = PTHREAD_COND_INITIALIZER};
+
+/* ========================================================================== */
+/* Writer Thread */
+/* ========================================================================== */
+
+/**
+ * @brief Shift <path>.N-1 -> <path>.N ... <path> -> <path>.1 and start a new file
+ */
+static void elog_file_rotate(elog_file_stats_t *delta)
+{
+  char from[256];
+  char to[256];
+
+  close(s_file.fd);
+  for (unsigned i = s_file.cfg.max_files - 1u; i > 0u; i--)
+  {
+    if (i == 1u) { snprintf(from, sizeof(from), "%s", s_file.cfg.path); }
+    else { snprintf(from, sizeof(from), "%s.%u", s_file.cfg.path, i - 1u); }
+    snprintf(to, sizeof(to), "%s.%u", s_file.cfg.path, i);
+    rename(from, to);
+  }
+  s_file.fd = open(s_file.cfg.path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+  if (s_file.fd < 0) { delta->write_errors++; }
+  s_file.file_bytes = 0;
+  s_file.line_open = false;
+  delta->rotations++;
+}
+
+/**
+ * @brief Write bytes completely to the current file
+ * @return false on a write error (counted in delta)
+ */
+static bool elog_file_write_all(const uint8_t *data, size_t len, elog_file_stats_t *delta)
+{
+  while (len > 0u)
+  {
+    ssize_t n = write(s_file.fd, data, len);
+    if (n < 0)
+    {
+      if (errno == EINTR) { continue; }
+      delta->write_errors++;
+      return false;
+    }
+    data += n;
+    len -= (size_t)n;
+    s_file.file_bytes += (size_t)n;
+    delta->bytes_written += (uint64_t)n;
+  }
+  return true;
+}
+
+/**
+ * @brief Write a chunk, rotating at a line boundary when the file would exceed max_bytes
+ * @note  Chunks are cut from the ring without regard to lines: the lines that fit go to the
+ *        current file, a line split by the previous chunk is finished first, and a single line
+ *        longer than max_bytes is written whole. Runs unlocked; counters go to delta and are
+ *        merged under the lock.
+ */
+static void elog_file_write_chunk(const uint8_t *data, size_t len, elog_file_stats_t *delta)
+{
+  const bool rotating = s_file.cfg.max_bytes != 0u && s_file.cfg.max_files > 1u;
+  while (len > 0u)
+  {
+    if (s_file.fd < 0)
+    {
+      delta->write_errors++; // No file (reopen after rotation failed): the chunk is lost
+      return;
+    }
+
+    size_t n = len;
+    if (rotating && s_file.file_bytes + len > s_file.cfg.max_bytes)
+    {
+      /* Up to the last newline that still fits */
+      size_t room = (s_file.file_bytes < s_file.cfg.max_bytes) ? s_file.cfg.max_bytes - s_file.file_bytes : 0u;
+      n = (room < len) ? room : len;
+      while (n > 0u && data[n - 1u] != '\n') { n--; }
+      if (n == 0u && (s_file.line_open || s_file.file_bytes == 0u))
+      {
+        /* Nothing fits: finish the open line (or an oversized one) before rotating */
+        const uint8_t *nl = (const uint8_t *)memchr(data, '\n', len);
+        n = (nl != NULL) ? (size_t)(nl - data) + 1u : len;
+      }
+    }
+
+    if (n > 0u)
+    {
+      if (!elog_file_write_all(data, n, delta)) { return; }
+      s_file.line_open = (data[n - 1u] != '\n');
+      data += n;
+      len -= n;
+    }
+    if (len > 0u && !s_file.line_open)
+    {
+      elog_file_rotate(delta);
+    }
+  }
+}
+
+static void *elog_file_writer(void *arg)
+{
+  (void)arg;
+  pthread_mutex_lock(&s_file.lock);
+  for (;;)
+  {
+    /* Sleep until a full chunk is buffered, a flush is requested, or the interval expires */
+    if (!s_file.stop && !s_file.flush_requested && ring_available(&s_file.ring) < s_file.cfg.chunk_size)
+    {
+      struct timespec deadline;
+      clock_gettime(CLOCK_REALTIME, &deadline);
+      deadline.tv_nsec += (long)(s_file.cfg.flush_interval_ms % 1000u) * 1000000L;
+      deadline.tv_sec += (time_t)(s_file.cfg.flush_interval_ms / 1000u) + deadline.tv_nsec / 1000000000L;
+      deadline.tv_nsec %= 1000000000L;
+      pthread_cond_timedwait(&s_file.data_ready, &s_file.lock, &deadline);
+    }
+
+    /* Take whole lines only (the subscriber stores whole lines); a line longer than a chunk is split */
+    uint32_t n = ring_peek_front_multiple(&s_file.ring, s_file.chunk, (uint32_t)s_file.cfg.chunk_size);
+    uint32_t whole = n;
+    while (whole > 0u && s_file.chunk[whole - 1u] != '\n') { whole--; }
+    if (whole != 0u) { n = whole; }
+    RingBuffer_PopFrontMultiple(&s_file.ring, n);
+    if (n != 0u)
+    {
+      /* Only the copy-out holds the lock; the syscall runs unlocked */
+      elog_file_stats_t delta = {0};
+      pthread_mutex_unlock(&s_file.lock);
+      elog_file_write_chunk(s_file.chunk, n, &delta);
+      pthread_mutex_lock(&s_file.lock);
+      s_file.stats.bytes_written += delta.bytes_written;
+      s_file.stats.rotations += delta.rotations;
+      s_file.stats.write_errors += delta.write_errors;
+      continue;
+    }
+
+    s_file.flush_requested = false;
+    pthread_cond_broadcast(&s_file.drained);
+    if (s_file.stop) { break; }
+  }
+  pthread_mutex_unlock(&s_file.lock);
+  return NULL;
+}
+
+/* ========================================================================== */
+/* Public API */
+/* ========================================================================== */
+
+/**
+ * @brief Open the log file and start the writer thread
+ * @param cfg: Configuration (the path string must stay valid); zero fields take defaults
+ * @return ELOG_ERR_NONE, ELOG_ERR_INVALID_PARAM for a bad config, ELOG_ERR_INVALID_STATE if already
+ *         open or the file, buffers or thread cannot be created
+ */
+elog_err_t elog_file_open(const elog_file_config_t *cfg)
+{
+  if (cfg == NULL || cfg->path == NULL) { return ELOG_ERR_INVALID_PARAM; }
+  if (s_file.open) { return ELOG_ERR_INVALID_STATE; }
+
+  s_file.cfg = *cfg;
+  if (s_file.cfg.buffer_size == 0u) { s_file.cfg.buffer_size = ELOG_FILE_BUFFER_SIZE; }
+  if (s_file.cfg.chunk_size == 0u) { s_file.cfg.chunk_size = ELOG_FILE_CHUNK_SIZE; }
+  if (s_file.cfg.flush_interval_ms == 0u) { s_file.cfg.flush_interval_ms = ELOG_FILE_FLUSH_MS; }
+  if (s_file.cfg.chunk_size > s_file.cfg.buffer_size) { s_file.cfg.chunk_size = s_file.cfg.buffer_size; }
+
+  if (!ring_init_dynamic(&s_file.ring, (uint32_t)s_file.cfg.buffer_size, 1)) { return ELOG_ERR_INVALID_STATE; }
+  size_t chunk_alloc = (s_file.cfg.chunk_size + ELOG_FILE_ALIGN - 1u) & ~(size_t)(ELOG_FILE_ALIGN - 1u);
+  if (posix_memalign((void **)&s_file.chunk, ELOG_FILE_ALIGN, chunk_alloc) != 0)
+  {
+    ring_destroy(&s_file.ring);
+    return ELOG_ERR_INVALID_STATE;
+  }
+
+  s_file.fd = open(s_file.cfg.path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+  struct stat st;
+  s_file.file_bytes = (s_file.fd >= 0 && fstat(s_file.fd, &st) == 0) ? (size_t)st.st_size : 0u;
+  s_file.line_open = false;
+  memset(&s_file.stats, 0, sizeof(s_file.stats));
+  s_file.stop = false;
+  s_file.flush_requested = false;
+  if (s_file.fd < 0 || pthread_create(&s_file.thread, NULL, elog_file_writer, NULL) != 0)
+  {
+    if (s_file.fd >= 0) { close(s_file.fd); }
+    s_file.fd = -1;
+    free(s_file.chunk);
+    ring_destroy(&s_file.ring);
+    return ELOG_ERR_INVALID_STATE;
+  }
+  s_file.open = true;
+  return ELOG_ERR_NONE;
+}
+
+/**
+ * @brief Text subscriber: copy the line into the buffer ring (never blocks on I/O)
+ * @param handle: Unused
+ * @param buf: Message buffer
+ * @param len: Length of message
+ * @return Always 0
+ */
+int elog_file_subscriber(int handle, const char *buf, size_t len)
+{
+  (void)handle;
+  if (!s_file.open) { return 0; }
+
+  pthread_mutex_lock(&s_file.lock);
+  if (!s_file.open)
+  {
+    /* elog_file_close() ran while this call waited for the lock: the ring is gone */
+    pthread_mutex_unlock(&s_file.lock);
+    return 0;
+  }
+  if (ring_get_free(&s_file.ring) >= len)
+  {
+    ring_write_multiple(&s_file.ring, buf, (uint32_t)len);
+    if (ring_available(&s_file.ring) >= s_file.cfg.chunk_size) { pthread_cond_signal(&s_file.data_ready); }
+  }
+  else
+  {
+    s_file.stats.dropped++; // Writer cannot keep up: drop whole lines, never block the logger
+  }
+  pthread_mutex_unlock(&s_file.lock);
+  return 0;
+}
+
+/**
+ * @brief Write out everything buffered so far and wait for it
+ */
+void elog_file_flush(void)
+{
+  if (!s_file.open) { return; }
+  pthread_mutex_lock(&s_file.lock);
+  s_file.flush_requested = true;
+  pthread_cond_signal(&s_file.data_ready);
+  while (s_file.flush_requested) { pthread_cond_wait(&s_file.drained, &s_file.lock); }
+  pthread_mutex_unlock(&s_file.lock);
+}
+
+/**
+ * @brief Drain the buffer, stop the writer thread and close the file
+ * @note  Safe against concurrent elog_file_subscriber() calls: lines logged from here on are ignored.
+ */
+void elog_file_close(void)
+{
+  if (!s_file.open) { return; }
+  pthread_mutex_lock(&s_file.lock);
+  s_file.open = false;
+  s_file.stop = true;
+  pthread_cond_signal(&s_file.data_ready);
+  pthread_mutex_unlock(&s_file.lock);
+  pthread_join(s_file.thread, NULL);
+
+  /* Under the lock: a subscriber call still in flight either finished its copy or sees !open */
+  pthread_mutex_lock(&s_file.lock);
+  close(s_file.fd);
+  s_file.fd = -1;
+  free(s_file.chunk);
+  s_file.chunk = NULL;
+  ring_destroy(&s_file.ring);
+  pthread_mutex_unlock(&s_file.lock);
+}
+
+/**
+ * @brief Get a copy of the file subscriber counters
+ * @param stats: Destination
+ */
+void elog_file_get_stats(elog_file_stats_t *stats)
+{
+  pthread_mutex_lock(&s_file.lock);
+  *stats = s_file.stats;
+  pthread_mutex_unlock(&s_file.lock);
+}
+#endif
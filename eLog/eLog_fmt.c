@@ -0,0 +1,1086 @@
+/***********************************************************
+ * @file	eLog_fmt.c
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Lightweight printf engine for eLog
+ *         Supports the conversions used by log statements:
+ *         %d %i %u %x %X %o %c %s %p %f %e %g %% with flags (- 0 + space #),
+ *         width, precision ('*' accepted) and hh/h/l/ll/z/j/t lengths.
+ *         Decimal ties are resolved on the exact binary value, round half
+ *         to even, like libc. %f keeps at most 9 decimals and %e/%g at most
+ *         17 significant digits. The L length (long double) is rejected: the
+ *         directive and the rest of the format are emitted verbatim.
+ *         No heap, no locale, no libc printf dependency.
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+
+#include "eLog.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ========================================================================== */
+/* Conversion Tables */
+/* ========================================================================== */
+
+/* Two decimal digits per lookup: halves the number of divisions */
+static const char s_dec_pairs[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'};
+
+static const char s_hex_lower[16] = {'0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f'};
+static const char s_hex_upper[16] = {'0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'};
+
+/* Powers of ten for the fixed-point fraction (precision is clamped to 9) */
+static const uint32_t s_pow10[10] = {1u, 10u, 100u, 1000u, 10000u, 100000u,
+                                     1000000u, 10000000u, 100000000u, 1000000000u};
+
+/* Exact powers of ten as doubles (10^22 is the largest one a double holds exactly) */
+static const double s_pow10d[23] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+#define ELOG_FMT_MAX_FLOAT_PRECISION 9
+#define ELOG_FMT_MAX_SIGNIFICANT 17 /* %e/%g digits; enough to round-trip a double */
+#define ELOG_FMT_BIG_LIMBS 86        /* Base-10^9 limbs of the longest exact expansion (767 digits) */
+#define ELOG_FMT_NUM_BUF 24 /* 64-bit octal needs 22 digits */
+
+/* ========================================================================== */
+/* Output Helpers */
+/* ========================================================================== */
+
+/**
+ * @brief Bounded output cursor; len keeps counting past the end like snprintf
+ */
+typedef struct
+{
+  char *buf;
+  size_t size;
+  size_t len;
+} elog_fmt_out_t;
+
+static inline void out_char(elog_fmt_out_t *o, char c)
+{
+  if (o->len + 1 < o->size) { o->buf[o->len] = c; }
+  o->len++;
+}
+
+static inline void out_repeat(elog_fmt_out_t *o, char c, int count)
+{
+  while (count-- > 0) { out_char(o, c); }
+}
+
+static void out_mem(elog_fmt_out_t *o, const char *s, size_t n)
+{
+  if (o->len + 1 < o->size)
+  {
+    size_t room = o->size - 1 - o->len;
+    size_t copy = (n < room) ? n : room;
+    memcpy(o->buf + o->len, s, copy);
+  }
+  o->len += n;
+}
+
+/* ========================================================================== */
+/* Integer Conversion */
+/* ========================================================================== */
+
+/**
+ * @brief Convert an unsigned value to decimal, writing backwards from end
+ * @return Pointer to the first digit
+ */
+static char *u64_to_dec(uint64_t v, char *end)
+{
+  char *p = end;
+  /* Narrow to 32-bit as soon as possible: 64-bit division is a library call on Cortex-M */
+  while (v > UINT32_MAX)
+  {
+    uint32_t rem = (uint32_t)(v % 100u);
+    v /= 100u;
+    p -= 2;
+    memcpy(p, &s_dec_pairs[rem * 2u], 2);
+  }
+  uint32_t w = (uint32_t)v;
+  while (w >= 100u)
+  {
+    uint32_t rem = w % 100u;
+    w /= 100u;
+    p -= 2;
+    memcpy(p, &s_dec_pairs[rem * 2u], 2);
+  }
+  if (w >= 10u)
+  {
+    p -= 2;
+    memcpy(p, &s_dec_pairs[w * 2u], 2);
+  }
+  else
+  {
+    *--p = (char)('0' + w);
+  }
+  return p;
+}
+
+/**
+ * @brief Convert an unsigned value to a power-of-two base, writing backwards from end
+ * @return Pointer to the first digit
+ */
+static char *u64_to_pow2(uint64_t v, char *end, unsigned shift, const char *digits)
+{
+  char *p = end;
+  const unsigned mask = (1u << shift) - 1u;
+  do
+  {
+    *--p = digits[v & mask];
+    v >>= shift;
+  } while (v != 0);
+  return p;
+}
+
+/* ========================================================================== */
+/* Conversion Specification */
+/* ========================================================================== */
+
+#define FLAG_LEFT  0x01u
+#define FLAG_ZERO  0x02u
+#define FLAG_PLUS  0x04u
+#define FLAG_SPACE 0x08u
+#define FLAG_ALT   0x10u
+
+typedef enum
+{
+  LEN_DEFAULT = 0,
+  LEN_HH,
+  LEN_H,
+  LEN_L,
+  LEN_LL,
+  LEN_Z,
+  LEN_J,
+  LEN_T,
+  LEN_BIG_L /* long double: rejected, see elog_vsnprintf() */
+} elog_fmt_len_t;
+
+typedef struct
+{
+  unsigned flags;
+  int width;
+  int precision; /* -1 when not specified */
+  elog_fmt_len_t length;
+} elog_fmt_spec_t;
+
+/**
+ * @brief Emit a number (digits already converted) with sign/prefix, precision and width padding
+ */
+static void out_number(elog_fmt_out_t *o, const elog_fmt_spec_t *spec, const char *digits, int ndigits,
+                       const char *prefix, int nprefix)
+{
+  int zeros = 0;
+  if (spec->precision >= 0)
+  {
+    /* "%.0d" of zero prints nothing */
+    if (spec->precision == 0 && ndigits == 1 && digits[0] == '0') { ndigits = 0; }
+    if (spec->precision > ndigits) { zeros = spec->precision - ndigits; }
+  }
+  int total = nprefix + zeros + ndigits;
+  int pad = (spec->width > total) ? spec->width - total : 0;
+
+  if (!(spec->flags & FLAG_LEFT) && !((spec->flags & FLAG_ZERO) && spec->precision < 0)) { out_repeat(o, ' ', pad); }
+  out_mem(o, prefix, (size_t)nprefix);
+  if (!(spec->flags & FLAG_LEFT) && (spec->flags & FLAG_ZERO) && spec->precision < 0) { out_repeat(o, '0', pad); }
+  out_repeat(o, '0', zeros);
+  out_mem(o, digits, (size_t)ndigits);
+  if (spec->flags & FLAG_LEFT) { out_repeat(o, ' ', pad); }
+}
+
+static void out_padded(elog_fmt_out_t *o, const elog_fmt_spec_t *spec, const char *s, size_t n)
+{
+  int pad = (spec->width > (int)n) ? spec->width - (int)n : 0;
+  if (!(spec->flags & FLAG_LEFT)) { out_repeat(o, ' ', pad); }
+  out_mem(o, s, n);
+  if (spec->flags & FLAG_LEFT) { out_repeat(o, ' ', pad); }
+}
+
+static char sign_char(const elog_fmt_spec_t *spec, bool negative)
+{
+  if (negative) { return '-'; }
+  if (spec->flags & FLAG_PLUS) { return '+'; }
+  if (spec->flags & FLAG_SPACE) { return ' '; }
+  return 0;
+}
+
+/* ========================================================================== */
+/* Argument Fetching */
+/* ========================================================================== */
+
+static int64_t fetch_signed(va_list *ap, elog_fmt_len_t length)
+{
+  switch (length)
+  {
+  case LEN_HH: return (signed char)va_arg(*ap, int);
+  case LEN_H:  return (short)va_arg(*ap, int);
+  case LEN_L:  return va_arg(*ap, long);
+  case LEN_LL: return va_arg(*ap, long long);
+  case LEN_Z:  return (int64_t)va_arg(*ap, size_t);
+  case LEN_J:  return va_arg(*ap, intmax_t);
+  case LEN_T:  return va_arg(*ap, ptrdiff_t);
+  default:     return va_arg(*ap, int);
+  }
+}
+
+static uint64_t fetch_unsigned(va_list *ap, elog_fmt_len_t length)
+{
+  switch (length)
+  {
+  case LEN_HH: return (unsigned char)va_arg(*ap, unsigned int);
+  case LEN_H:  return (unsigned short)va_arg(*ap, unsigned int);
+  case LEN_L:  return va_arg(*ap, unsigned long);
+  case LEN_LL: return va_arg(*ap, unsigned long long);
+  case LEN_Z:  return va_arg(*ap, size_t);
+  case LEN_J:  return va_arg(*ap, uintmax_t);
+  case LEN_T:  return (uint64_t)va_arg(*ap, ptrdiff_t);
+  default:     return va_arg(*ap, unsigned int);
+  }
+}
+
+/* ========================================================================== */
+/* Floating Point */
+/* ========================================================================== */
+
+/**
+ * @brief Exact rounding error of the double product p = a * b (Dekker's two-product, no FMA needed)
+ * @return a * b - p, exactly
+ */
+static double product_error(double a, double b, double p)
+{
+  const double split = 134217729.0; /* 2^27 + 1 */
+  double t = split * a;
+  double ah = t - (t - a);
+  double al = a - ah;
+  t = split * b;
+  double bh = t - (t - b);
+  double bl = b - bh;
+  return (((ah * bh - p) + ah * bl) + al * bh) + al * bl;
+}
+
+/**
+ * @brief Emit "nan"/"inf" (upper case for %F/%E/%G); the '0' flag and precision do not apply
+ */
+static void out_nonfinite(elog_fmt_out_t *o, const elog_fmt_spec_t *spec, const char *text, const char *prefix,
+                          int nprefix)
+{
+  elog_fmt_spec_t plain = *spec;
+  plain.precision = -1;
+  plain.flags &= ~FLAG_ZERO;
+  out_number(o, &plain, text, 3, prefix, nprefix);
+}
+
+/**
+ * @brief v * 10^k rounded to the nearest integer, decimal ties resolved on the exact binary value (half to even)
+ * @note  Exact whenever it succeeds: one correctly rounded operation by an exact power of ten plus its
+ *        exact error term. Fails (returns false) for |k| > 22 or results of 2^53 and above.
+ */
+static bool scale_round(double v, int k, uint64_t *out)
+{
+  if (k > 22 || k < -22) { return false; }
+  double y;
+  double err; /* Sign of (exact - y) */
+  if (k >= 0)
+  {
+    y = v * s_pow10d[k];
+    err = product_error(v, s_pow10d[k], y);
+  }
+  else
+  {
+    double p = s_pow10d[-k];
+    y = v / p;
+    double back = y * p;
+    err = (v - back) - product_error(y, p, back); /* v - back is exact (Sterbenz) */
+  }
+  if (y >= 9007199254740992.0) { return false; } /* 2^53: y no longer resolves the fraction */
+
+  uint64_t n = (uint64_t)y;
+  double rem = y - (double)n;
+  if (rem > 0.5 || (rem == 0.5 && (err > 0.0 || (err == 0.0 && (n & 1u) != 0u)))) { n++; }
+  *out = n;
+  return true;
+}
+
+/**
+ * @brief limb *= mul over base-10^9 limbs (little-endian), mul <= 2^31
+ * @return New number of limbs
+ */
+static int limbs_mul(uint32_t *limb, int nlimb, uint32_t mul)
+{
+  uint64_t carry = 0;
+  for (int i = 0; i < nlimb; i++)
+  {
+    uint64_t t = (uint64_t)limb[i] * mul + carry;
+    limb[i] = (uint32_t)(t % 1000000000u);
+    carry = t / 1000000000u;
+  }
+  for (; carry != 0u; carry /= 1000000000u) { limb[nlimb++] = (uint32_t)(carry % 1000000000u); }
+  return nlimb;
+}
+
+/**
+ * @brief Exact decimal expansion of a finite v > 0: v = N * 10^point, N in base-10^9 limbs
+ * @note  m * 2^e is m * 2^e for e >= 0 and m * 5^-e * 10^e otherwise; the largest N (subnormals)
+ *        has 767 digits, so limb must hold ELOG_FMT_BIG_LIMBS entries.
+ * @return Number of limbs used
+ */
+static int expand_decimal(double v, uint32_t *limb, int *point)
+{
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  int biased = (int)((bits >> 52) & 0x7FFu);
+  uint64_t m = bits & 0xFFFFFFFFFFFFFull;
+  int e = (biased == 0) ? -1074 : biased - 1075; /* Subnormals have no implicit bit */
+  if (biased != 0) { m |= 1ull << 52; }
+
+  int nlimb = 0;
+  for (; m != 0u; m /= 1000000000u) { limb[nlimb++] = (uint32_t)(m % 1000000000u); }
+  *point = (e < 0) ? e : 0;
+  for (; e >= 29; e -= 29) { nlimb = limbs_mul(limb, nlimb, 1u << 29); }
+  if (e > 0) { nlimb = limbs_mul(limb, nlimb, 1u << e); }
+  for (; e <= -13; e += 13) { nlimb = limbs_mul(limb, nlimb, 1220703125u); } /* 5^13 */
+  for (; e < 0; e++) { nlimb = limbs_mul(limb, nlimb, 5u); }
+  return nlimb;
+}
+
+/**
+ * @brief Decimal digit i of the limbs, counted from the least significant
+ */
+static unsigned limbs_digit(const uint32_t *limb, int i)
+{
+  return (limb[i / 9] / (uint32_t)s_pow10[i % 9]) % 10u;
+}
+
+/**
+ * @brief round_significant() through the exact expansion: for exponents scale_round() cannot reach
+ */
+static __attribute__((noinline)) uint64_t round_significant_exact(double v, int ndig, int *exp10)
+{
+  uint32_t limb[ELOG_FMT_BIG_LIMBS];
+  int point;
+  int nlimb = expand_decimal(v, limb, &point);
+  int ndigits = 9 * (nlimb - 1);
+  for (uint32_t top = limb[nlimb - 1]; top != 0u; top /= 10u) { ndigits++; }
+
+  uint64_t n = 0;
+  int i = ndigits - 1;
+  for (int d = 0; d < ndig; d++, i--) { n = n * 10u + ((i >= 0) ? limbs_digit(limb, i) : 0u); }
+  if (i >= 0)
+  {
+    /* First dropped digit, then whether anything non-zero follows it */
+    unsigned first = limbs_digit(limb, i);
+    bool sticky = false;
+    for (int k = i - 1; k >= 0 && !sticky; k--) { sticky = limbs_digit(limb, k) != 0u; }
+    if (first > 5u || (first == 5u && (sticky || (n & 1u) != 0u))) { n++; }
+  }
+  *exp10 = ndigits - 1 + point;
+  if (n >= (uint64_t)s_pow10d[ndig])
+  {
+    n /= 10u;
+    (*exp10)++;
+  }
+  return n;
+}
+
+/**
+ * @brief Round v (finite, > 0) to ndig significant decimal digits
+ * @param exp10: Out: decimal exponent of the leading digit
+ * @return The digits as an integer in [10^(ndig-1), 10^ndig)
+ */
+static uint64_t round_significant(double v, int ndig, int *exp10)
+{
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  /* Estimate from the binary exponent (log10(2) ~ 0.30103), then correct by whole decades */
+  int e2 = (int)((bits >> 52) & 0x7FFu) - 1023;
+  int e = (e2 >= 0) ? (e2 * 30103) / 100000 : -((-e2 * 30103 + 99999) / 100000);
+  const uint64_t lo = (uint64_t)s_pow10d[ndig - 1];
+  for (int guard = 0; guard < 4; guard++)
+  {
+    uint64_t n;
+    if (!scale_round(v, ndig - 1 - e, &n)) { break; }
+    if (n >= lo * 10u) { e++; }
+    else if (n < lo) { e--; }
+    else
+    {
+      *exp10 = e;
+      return n;
+    }
+  }
+  return round_significant_exact(v, ndig, exp10);
+}
+
+/**
+ * @brief %f of a value of 2^64 or more: every such double is an integer, printed exactly
+ * @note  Kept out of line so its ~700 bytes of buffers are only on the stack for such values.
+ */
+static __attribute__((noinline)) void out_float_big(elog_fmt_out_t *o, const elog_fmt_spec_t *spec, double v,
+                                                    int prec, const char *prefix, int nprefix)
+{
+  uint32_t limb[ELOG_FMT_BIG_LIMBS];
+  int point;
+  int nlimb = expand_decimal(v, limb, &point); /* point is 0: v is an integer */
+
+  char buf[36 * 9 + 2 + ELOG_FMT_MAX_FLOAT_PRECISION]; /* DBL_MAX has 309 digits */
+  char *const end = buf + sizeof(buf);
+  char *p = end - prec;
+  for (int i = 0; i < prec; i++) { p[i] = '0'; }
+  if (prec > 0 || (spec->flags & FLAG_ALT)) { *--p = '.'; }
+  for (int i = 0; i < nlimb - 1; i++)
+  {
+    char *d = u64_to_dec(limb[i], p);
+    while (p - d < 9) { *--d = '0'; }
+    p = d;
+  }
+  p = u64_to_dec(limb[nlimb - 1], p);
+
+  elog_fmt_spec_t num = *spec;
+  num.precision = -1;
+  out_number(o, &num, p, (int)(end - p), prefix, nprefix);
+}
+
+static void out_float(elog_fmt_out_t *o, const elog_fmt_spec_t *spec, double v, bool upper)
+{
+  char buf[ELOG_FMT_NUM_BUF + ELOG_FMT_MAX_FLOAT_PRECISION + 2];
+  char *end = buf + sizeof(buf);
+  char prefix[1];
+  int nprefix = 0;
+  bool negative = __builtin_signbit(v) != 0; /* -0.0 prints "-0.000000" like libc */
+  if (negative) { v = -v; }
+
+  char s = sign_char(spec, negative);
+  if (s) { prefix[nprefix++] = s; }
+
+  if (v != v)
+  {
+    out_nonfinite(o, spec, upper ? "NAN" : "nan", prefix, nprefix);
+    return;
+  }
+  if (__builtin_isinf(v))
+  {
+    out_nonfinite(o, spec, upper ? "INF" : "inf", prefix, nprefix);
+    return;
+  }
+
+  int prec = (spec->precision < 0) ? 6 : spec->precision;
+  if (prec > ELOG_FMT_MAX_FLOAT_PRECISION) { prec = ELOG_FMT_MAX_FLOAT_PRECISION; }
+
+  if (v >= 18446744073709551616.0)
+  {
+    /* Beyond uint64_t: every such double is an integer */
+    out_float_big(o, spec, v, prec, prefix, nprefix);
+    return;
+  }
+
+  uint64_t ipart = (uint64_t)v;
+  double frac = (v - (double)ipart) * (double)s_pow10[prec];
+  uint32_t fpart = (uint32_t)frac;
+  double rem = frac - (double)fpart;
+  if (rem == 0.5)
+  {
+    /* The scaling may have rounded onto the tie: the exact product decides (0.35 is 0.3499...) */
+    double err = product_error(v - (double)ipart, (double)s_pow10[prec], frac);
+    if (err != 0.0) { rem = (err > 0.0) ? 1.0 : 0.0; }
+  }
+  /* Round half to even on the last printed digit (the units digit when prec == 0) */
+  bool odd = (prec == 0) ? ((ipart & 1u) != 0u) : ((fpart & 1u) != 0u);
+  if (rem > 0.5 || (rem == 0.5 && odd))
+  {
+    fpart++;
+    if (fpart >= s_pow10[prec])
+    {
+      fpart = 0;
+      ipart++;
+    }
+  }
+
+  char *p = end;
+  if (prec > 0)
+  {
+    char *frac_start = u64_to_dec(fpart, end);
+    int nfrac = (int)(end - frac_start);
+    p = frac_start;
+    while (nfrac++ < prec) { *--p = '0'; }
+    *--p = '.';
+  }
+  else if (spec->flags & FLAG_ALT)
+  {
+    *--p = '.';
+  }
+  p = u64_to_dec(ipart, p);
+
+  elog_fmt_spec_t num = *spec;
+  num.precision = -1; /* precision already consumed by the fraction */
+  out_number(o, &num, p, (int)(end - p), prefix, nprefix);
+}
+
+/**
+ * @brief %e/%E and %g/%G: the value rounded to significant digits, laid out like libc
+ * @note  Precision is clamped so at most ELOG_FMT_MAX_SIGNIFICANT digits are significant;
+ *        %e pads the remaining requested digits with zeros.
+ */
+static void out_float_exp(elog_fmt_out_t *o, const elog_fmt_spec_t *spec, double v, char conv)
+{
+  const bool upper = (conv == 'E' || conv == 'G');
+  const bool general = (conv == 'g' || conv == 'G');
+  const bool alt = (spec->flags & FLAG_ALT) != 0u;
+  char prefix[1];
+  int nprefix = 0;
+  bool negative = __builtin_signbit(v) != 0;
+  if (negative) { v = -v; }
+
+  char s = sign_char(spec, negative);
+  if (s) { prefix[nprefix++] = s; }
+
+  if (v != v)
+  {
+    out_nonfinite(o, spec, upper ? "NAN" : "nan", prefix, nprefix);
+    return;
+  }
+  if (__builtin_isinf(v))
+  {
+    out_nonfinite(o, spec, upper ? "INF" : "inf", prefix, nprefix);
+    return;
+  }
+
+  int prec = (spec->precision < 0) ? 6 : spec->precision;
+  int want = general ? ((prec == 0) ? 1 : prec) : prec + 1; /* Significant digits requested */
+  int nsig = (want > ELOG_FMT_MAX_SIGNIFICANT) ? ELOG_FMT_MAX_SIGNIFICANT : want;
+
+  char sig[ELOG_FMT_NUM_BUF];
+  int exp10 = 0;
+  if (v == 0.0)
+  {
+    for (int i = 0; i < nsig; i++) { sig[i] = '0'; }
+  }
+  else
+  {
+    (void)u64_to_dec(round_significant(v, nsig, &exp10), sig + nsig); /* Exactly nsig digits */
+  }
+
+  /* %g: fixed-point unless the exponent is below -4 or not below the precision */
+  const bool exp_style = !general || exp10 < -4 || exp10 >= want;
+  int ndig = nsig;
+  if (general && !alt)
+  {
+    while (ndig > 1 && sig[ndig - 1] == '0') { ndig--; }
+  }
+  else if (general)
+  {
+    want = nsig; /* '#' keeps trailing zeros, up to the clamp */
+  }
+  int pad = (!general && want > nsig) ? want - nsig : 0; /* %e digits past the clamp */
+
+  char buf[ELOG_FMT_NUM_BUF + ELOG_FMT_MAX_SIGNIFICANT + 8];
+  int n = 0;
+  if (exp_style)
+  {
+    buf[n++] = sig[0];
+    if (ndig > 1 || pad > 0 || alt) { buf[n++] = '.'; }
+    for (int i = 1; i < ndig; i++) { buf[n++] = sig[i]; }
+    for (int i = 0; i < pad; i++) { buf[n++] = '0'; }
+    buf[n++] = upper ? 'E' : 'e';
+    buf[n++] = (exp10 < 0) ? '-' : '+';
+    unsigned mag = (unsigned)((exp10 < 0) ? -exp10 : exp10);
+    if (mag >= 100u) { buf[n++] = (char)('0' + mag / 100u); }
+    buf[n++] = (char)('0' + (mag / 10u) % 10u);
+    buf[n++] = (char)('0' + mag % 10u);
+  }
+  else if (exp10 >= 0)
+  {
+    int i = 0;
+    for (; i <= exp10; i++) { buf[n++] = sig[i]; }
+    if (ndig > i || alt) { buf[n++] = '.'; }
+    for (; i < ndig; i++) { buf[n++] = sig[i]; }
+  }
+  else
+  {
+    buf[n++] = '0';
+    buf[n++] = '.';
+    for (int i = -1; i > exp10; i--) { buf[n++] = '0'; }
+    for (int i = 0; i < ndig; i++) { buf[n++] = sig[i]; }
+  }
+
+  elog_fmt_spec_t num = *spec;
+  num.precision = -1; /* precision already consumed by the digits */
+  out_number(o, &num, buf, n, prefix, nprefix);
+}
+
+/* ========================================================================== */
+/* Engine */
+/* ========================================================================== */
+
+/**
+ * @brief Parse flags, width, precision and length of one conversion
+ * @param p: In: points after '%'. Out: points at the conversion character.
+ */
+static void parse_spec(const char **p, va_list *ap, elog_fmt_spec_t *spec)
+{
+  const char *f = *p;
+  spec->flags = 0;
+  spec->width = 0;
+  spec->precision = -1;
+  spec->length = LEN_DEFAULT;
+
+  for (;; f++)
+  {
+    if (*f == '-') { spec->flags |= FLAG_LEFT; }
+    else if (*f == '0') { spec->flags |= FLAG_ZERO; }
+    else if (*f == '+') { spec->flags |= FLAG_PLUS; }
+    else if (*f == ' ') { spec->flags |= FLAG_SPACE; }
+    else if (*f == '#') { spec->flags |= FLAG_ALT; }
+    else { break; }
+  }
+
+  if (*f == '*')
+  {
+    spec->width = va_arg(*ap, int);
+    if (spec->width < 0)
+    {
+      spec->flags |= FLAG_LEFT;
+      spec->width = -spec->width;
+    }
+    f++;
+  }
+  else
+  {
+    while (*f >= '0' && *f <= '9') { spec->width = spec->width * 10 + (*f++ - '0'); }
+  }
+
+  if (*f == '.')
+  {
+    f++;
+    spec->precision = 0;
+    if (*f == '*')
+    {
+      spec->precision = va_arg(*ap, int);
+      if (spec->precision < 0) { spec->precision = -1; }
+      f++;
+    }
+    else
+    {
+      while (*f >= '0' && *f <= '9') { spec->precision = spec->precision * 10 + (*f++ - '0'); }
+    }
+  }
+
+  switch (*f)
+  {
+  case 'h':
+    f++;
+    if (*f == 'h') { spec->length = LEN_HH; f++; }
+    else { spec->length = LEN_H; }
+    break;
+  case 'l':
+    f++;
+    if (*f == 'l') { spec->length = LEN_LL; f++; }
+    else { spec->length = LEN_L; }
+    break;
+  case 'z': spec->length = LEN_Z; f++; break;
+  case 'j': spec->length = LEN_J; f++; break;
+  case 't': spec->length = LEN_T; f++; break;
+  case 'L': spec->length = LEN_BIG_L; f++; break;
+  default: break;
+  }
+  *p = f;
+}
+
+/**
+ * @brief Format into buf using the built-in engine (vsnprintf-compatible subset)
+ * @param buf: Destination buffer (may be NULL when size is 0)
+ * @param size: Size of the destination buffer including the terminator
+ * @param fmt: Printf-style format string
+ * @param args: Format arguments
+ * @return Number of characters that would have been written without truncation
+ */
+int elog_vsnprintf(char *buf, size_t size, const char *fmt, va_list args)
+{
+  elog_fmt_out_t o = {buf, size, 0};
+  char num[ELOG_FMT_NUM_BUF];
+  char *const num_end = num + sizeof(num);
+  va_list ap;
+  va_copy(ap, args);
+
+  const char *f = fmt;
+  while (*f)
+  {
+    /* Copy literal runs in one go */
+    const char *run = f;
+    while (*f && *f != '%') { f++; }
+    if (f != run) { out_mem(&o, run, (size_t)(f - run)); }
+    if (*f == '\0') { break; }
+
+    const char *directive = f++; /* skip '%' */
+    elog_fmt_spec_t spec;
+    parse_spec(&f, &ap, &spec);
+    if (spec.length == LEN_BIG_L)
+    {
+      /* long double is not supported: emit the rest verbatim instead of misreading every argument after it */
+      out_mem(&o, directive, strlen(directive));
+      break;
+    }
+
+    switch (*f)
+    {
+    case 'd':
+    case 'i':
+    {
+      int64_t v = fetch_signed(&ap, spec.length);
+      uint64_t mag = (v < 0) ? (uint64_t)0 - (uint64_t)v : (uint64_t)v;
+      char *d = u64_to_dec(mag, num_end);
+      char prefix[1];
+      char s = sign_char(&spec, v < 0);
+      if (s) { prefix[0] = s; }
+      out_number(&o, &spec, d, (int)(num_end - d), prefix, s ? 1 : 0);
+      break;
+    }
+    case 'u':
+    {
+      char *d = u64_to_dec(fetch_unsigned(&ap, spec.length), num_end);
+      out_number(&o, &spec, d, (int)(num_end - d), NULL, 0);
+      break;
+    }
+    case 'x':
+    case 'X':
+    {
+      uint64_t v = fetch_unsigned(&ap, spec.length);
+      char *d = u64_to_pow2(v, num_end, 4, (*f == 'x') ? s_hex_lower : s_hex_upper);
+      const char *prefix = (*f == 'x') ? "0x" : "0X";
+      out_number(&o, &spec, d, (int)(num_end - d), prefix, ((spec.flags & FLAG_ALT) && v != 0) ? 2 : 0);
+      break;
+    }
+    case 'o':
+    {
+      uint64_t v = fetch_unsigned(&ap, spec.length);
+      char *d = u64_to_pow2(v, num_end, 3, s_hex_lower);
+      bool alt = (spec.flags & FLAG_ALT) && v != 0;
+      out_number(&o, &spec, d, (int)(num_end - d), "0", alt ? 1 : 0);
+      break;
+    }
+    case 'p':
+    {
+      uintptr_t v = (uintptr_t)va_arg(ap, void *);
+      char *d = u64_to_pow2((uint64_t)v, num_end, 4, s_hex_lower);
+      out_number(&o, &spec, d, (int)(num_end - d), "0x", 2);
+      break;
+    }
+    case 'c':
+    {
+      char c = (char)va_arg(ap, int);
+      out_padded(&o, &spec, &c, 1);
+      break;
+    }
+    case 's':
+    {
+      const char *s = va_arg(ap, const char *);
+      if (s == NULL) { s = "(null)"; }
+      size_t n = 0;
+      if (spec.precision >= 0)
+      {
+        while (n < (size_t)spec.precision && s[n]) { n++; }
+      }
+      else
+      {
+        n = strlen(s);
+      }
+      out_padded(&o, &spec, s, n);
+      break;
+    }
+    case 'f':
+    case 'F':
+      out_float(&o, &spec, va_arg(ap, double), *f == 'F');
+      break;
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+      out_float_exp(&o, &spec, va_arg(ap, double), *f);
+      break;
+    case '%':
+      out_char(&o, '%');
+      break;
+    case '\0':
+      /* Dangling '%' at end of format */
+      f--;
+      break;
+    default:
+      /* Unsupported conversion: emit verbatim so the problem is visible in the log */
+      out_char(&o, '%');
+      out_char(&o, *f);
+      break;
+    }
+    f++;
+  }
+
+  va_end(ap);
+  if (size > 0) { buf[(o.len < size) ? o.len : size - 1] = '\0'; }
+  return (int)o.len;
+}
+
+/**
+ * @brief Format into buf using the built-in engine
+ * @param buf: Destination buffer
+ * @param size: Size of the destination buffer including the terminator
+ * @param fmt: Printf-style format string
+ * @param ...: Format arguments
+ * @return Number of characters that would have been written without truncation
+ */
+int elog_snprintf(char *buf, size_t size, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  int len = elog_vsnprintf(buf, size, fmt, args);
+  va_end(args);
+  return len;
+}
+
+/* ========================================================================== */
+/* Argument Hashing */
+/* ========================================================================== */
+
+#define ELOG_FNV_OFFSET 2166136261u
+#define ELOG_FNV_PRIME  16777619u
+
+static inline uint32_t fnv_bytes(uint32_t h, const void *data, size_t n)
+{
+  const uint8_t *b = (const uint8_t *)data;
+  while (n--) { h = (h ^ *b++) * ELOG_FNV_PRIME; }
+  return h;
+}
+
+/**
+ * @brief Hash the values a format string would consume, without formatting them
+ * @note  Strings are hashed by content (up to the precision), everything else by value.
+ * @param fmt: Printf-style format string
+ * @param args: Format arguments
+ * @return FNV-1a hash of the argument values
+ */
+uint32_t elog_fmt_hash_args(const char *fmt, va_list args)
+{
+  uint32_t h = ELOG_FNV_OFFSET;
+  va_list ap;
+  va_copy(ap, args);
+
+  for (const char *f = fmt; *f; f++)
+  {
+    if (*f != '%') { continue; }
+    f++;
+    elog_fmt_spec_t spec;
+    parse_spec(&f, &ap, &spec);
+    if (spec.length == LEN_BIG_L) { break; } /* Rejected like elog_vsnprintf(): nothing after it is read */
+
+    switch (*f)
+    {
+    case 'd':
+    case 'i':
+    {
+      int64_t v = fetch_signed(&ap, spec.length);
+      h = fnv_bytes(h, &v, sizeof(v));
+      break;
+    }
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+    {
+      uint64_t v = fetch_unsigned(&ap, spec.length);
+      h = fnv_bytes(h, &v, sizeof(v));
+      break;
+    }
+    case 'p':
+    {
+      void *v = va_arg(ap, void *);
+      h = fnv_bytes(h, &v, sizeof(v));
+      break;
+    }
+    case 'c':
+    {
+      int v = va_arg(ap, int);
+      h = fnv_bytes(h, &v, sizeof(v));
+      break;
+    }
+    case 's':
+    {
+      const char *s = va_arg(ap, const char *);
+      if (s == NULL) { s = "(null)"; }
+      size_t n = 0;
+      while ((spec.precision < 0 || n < (size_t)spec.precision) && s[n]) { n++; }
+      /* Hash only the printed bytes, then a terminator so "ab","c" and "a","bc" differ */
+      static const uint8_t terminator = 0u;
+      h = fnv_bytes(h, s, n);
+      h = fnv_bytes(h, &terminator, 1);
+      break;
+    }
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    {
+      double v = va_arg(ap, double);
+      h = fnv_bytes(h, &v, sizeof(v));
+      break;
+    }
+    case '\0':
+      f--;
+      break;
+    default:
+      break;
+    }
+  }
+
+  va_end(ap);
+  return h;
+}
+
+/* ========================================================================== */
+/* Deferred Arguments */
+/* ========================================================================== */
+
+/**
+ * @brief Capture the values a format string would consume into fixed-size slots
+ * @note  One slot per conversion (plus one per '*' width or precision), already widened:
+ *        signed integers to int64, unsigned to uint64, floats to double, %s/%p as pointers.
+ *        Strings are not copied, so they must outlive the deferred formatting.
+ * @param fmt: Printf-style format string
+ * @param args: Format arguments
+ * @param slots: Destination
+ * @param max: Number of slots available
+ * @return Number of slots the format needs (nothing past max is written)
+ */
+size_t elog_fmt_pack_args(const char *fmt, va_list args, elog_arg_t *slots, size_t max)
+{
+  size_t n = 0;
+  va_list ap;
+  va_copy(ap, args);
+
+  /* n == max + 1 means the slots ran out: stop, the caller drops the record */
+  for (const char *f = fmt; *f && n <= max; f++)
+  {
+    if (*f != '%') { continue; }
+    const char *start = ++f;
+    elog_fmt_spec_t spec;
+    parse_spec(&f, &ap, &spec);
+
+    /* '*' width and precision were consumed by parse_spec; keep them as slots of their own */
+    for (const char *c = start; c < f && n <= max; c++)
+    {
+      if (*c != '*') { continue; }
+      if (n == max) { n = max + 1u; break; }
+      slots[n++].i = (c > start && c[-1] == '.') ? spec.precision
+                                                 : (((spec.flags & FLAG_LEFT) ? -1 : 1) * spec.width);
+    }
+    if (*f == '\0' || spec.length == LEN_BIG_L) { break; } /* %L stops the format, as in elog_vsnprintf */
+    if (*f == '%' || n > max) { continue; }
+    if (n == max) { n = max + 1u; break; }
+
+    switch (*f)
+    {
+    case 'd':
+    case 'i': slots[n++].i = fetch_signed(&ap, spec.length); break;
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o': slots[n++].u = fetch_unsigned(&ap, spec.length); break;
+    case 'c': slots[n++].i = va_arg(ap, int); break;
+    case 'p':
+    case 's': slots[n++].p = va_arg(ap, const void *); break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G': slots[n++].f = va_arg(ap, double); break;
+    default: break; /* Unsupported conversion consumes nothing, as in elog_vsnprintf */
+    }
+  }
+
+  va_end(ap);
+  return n;
+}
+
+/* ========================================================================== */
+/* Hex Encoding */
+/* ========================================================================== */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+/**
+ * @brief Encode 16 bytes as 32 uppercase hex characters (SSE2, host builds)
+ */
+static inline void hex16_sse2(char *out, const uint8_t *in)
+{
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  const __m128i ascii0 = _mm_set1_epi8('0');
+  const __m128i nine = _mm_set1_epi8(9);
+  const __m128i alpha = _mm_set1_epi8('A' - '0' - 10);
+
+  __m128i v = _mm_loadu_si128((const __m128i *)in);
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+  __m128i lo = _mm_and_si128(v, nibble);
+  hi = _mm_add_epi8(_mm_add_epi8(hi, ascii0), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), alpha));
+  lo = _mm_add_epi8(_mm_add_epi8(lo, ascii0), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), alpha));
+  _mm_storeu_si128((__m128i *)out, _mm_unpacklo_epi8(hi, lo));
+  _mm_storeu_si128((__m128i *)(out + 16), _mm_unpackhi_epi8(hi, lo));
+}
+#endif
+
+/**
+ * @brief Encode bytes as uppercase hex ("0A 1B ..." with a separator, "0A1B..." without)
+ * @param out: Destination, at least len * 3 characters (len * 2 without separator); not terminated
+ * @param data: Bytes to encode
+ * @param len: Number of bytes
+ * @param sep: Separator between bytes, or '\0' for none (no trailing separator)
+ * @return Number of characters written
+ */
+size_t elog_hex_encode(char *out, const void *data, size_t len, char sep)
+{
+  const uint8_t *in = (const uint8_t *)data;
+  char *o = out;
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  char pairs[32];
+  for (; i + 16u <= len; i += 16u)
+  {
+    if (sep == '\0')
+    {
+      hex16_sse2(o, in + i);
+      o += 32;
+      continue;
+    }
+    hex16_sse2(pairs, in + i);
+    for (int j = 0; j < 16; j++)
+    {
+      o[0] = pairs[2 * j];
+      o[1] = pairs[2 * j + 1];
+      o[2] = sep;
+      o += 3;
+    }
+  }
+#endif
+
+  for (; i < len; i++)
+  {
+    o[0] = s_hex_upper[in[i] >> 4];
+    o[1] = s_hex_upper[in[i] & 0x0Fu];
+    o += 2;
+    if (sep != '\0') { *o++ = sep; }
+  }
+  if (sep != '\0' && o != out) { o--; }
+  return (size_t)(o - out);
+}
@@ -0,0 +1,197 @@
+/***********************************************************
+ * @file	eLog_mmap.c
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Memory-mapped log file subscriber for Linux/POSIX builds
+ *         A large address range is reserved once; the file is grown
+ *         and mapped into it chunk by chunk (MAP_FIXED), so existing
+ *         mappings never move. Logging a line is an atomic offset
+ *         reservation plus memcpy. The page cache owns the data, so
+ *         the log survives a crash of the process.
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+
+#include "eLog.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static struct
+{
+  uint8_t *base;          /* Start of the reserved address range (file offset 0) */
+  size_t reserve;         /* Size of the reserved range: hard limit of the file */
+  size_t chunk;           /* Growth step */
+  size_t offset;          /* Next free byte (atomic) */
+  size_t limit;           /* End of usable file: reserve, lowered to the first line that failed to map (atomic) */
+  size_t mapped;          /* Bytes of file currently mapped (atomic) */
+  size_t dropped;         /* Lines that did not fit in the reservation (atomic) */
+  int fd;
+  pthread_mutex_t grow_lock;
+} s_mmap = {.fd = -1, .grow_lock = PTHREAD_MUTEX_INITIALIZER};
+
+/**
+ * @brief Extend the file and map new chunks until at least `needed` bytes are mapped
+ * @param start: Offset of the line that needs the space
+ * @param needed: End of that line
+ * @note  On failure the file ends at `start`: later lines lie beyond it and are dropped too,
+ *        so the file never has a zero-filled hole between logged lines.
+ * @return true if the range is mapped
+ */
+static bool elog_mmap_grow(size_t start, size_t needed)
+{
+  pthread_mutex_lock(&s_mmap.grow_lock);
+  bool ok = (needed <= __atomic_load_n(&s_mmap.limit, __ATOMIC_RELAXED));
+  size_t mapped = __atomic_load_n(&s_mmap.mapped, __ATOMIC_ACQUIRE);
+  while (ok && mapped < needed)
+  {
+    size_t next = mapped + s_mmap.chunk;
+    if (next > s_mmap.reserve) { next = s_mmap.reserve; }
+    ok = (ftruncate(s_mmap.fd, (off_t)next) == 0);
+#if defined(__linux__)
+    /* Allocate blocks now so page faults on the hot path do not turn ENOSPC into SIGBUS */
+    if (ok) { ok = (posix_fallocate(s_mmap.fd, (off_t)mapped, (off_t)(next - mapped)) == 0); }
+#endif
+    if (ok)
+    {
+      ok = mmap(s_mmap.base + mapped, next - mapped, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, s_mmap.fd,
+                (off_t)mapped) != MAP_FAILED;
+    }
+    if (ok)
+    {
+      mapped = next;
+      __atomic_store_n(&s_mmap.mapped, mapped, __ATOMIC_RELEASE);
+    }
+  }
+  if (!ok && start < __atomic_load_n(&s_mmap.limit, __ATOMIC_RELAXED))
+  {
+    __atomic_store_n(&s_mmap.limit, start, __ATOMIC_RELAXED);
+  }
+  pthread_mutex_unlock(&s_mmap.grow_lock);
+  return ok;
+}
+
+/**
+ * @brief Create (truncate) the log file and reserve address space for it
+ * @param path: Log file path
+ * @param max_bytes: Largest file size; address space for it is reserved up front
+ * @param chunk_bytes: Growth step (rounded to pages; 0 = ELOG_MMAP_CHUNK_SIZE)
+ * @return Error code
+ */
+elog_err_t elog_mmap_open(const char *path, size_t max_bytes, size_t chunk_bytes)
+{
+  if (path == NULL || max_bytes == 0u) { return ELOG_ERR_INVALID_PARAM; }
+  if (s_mmap.fd >= 0) { return ELOG_ERR_INVALID_STATE; }
+
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  if (chunk_bytes == 0u) { chunk_bytes = ELOG_MMAP_CHUNK_SIZE; }
+  s_mmap.chunk = (chunk_bytes + page - 1u) / page * page;
+  s_mmap.reserve = (max_bytes + page - 1u) / page * page;
+
+  /* Reserve only address space: no memory is committed until a file chunk is mapped over it */
+  void *base = mmap(NULL, s_mmap.reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) { return ELOG_ERR_INVALID_STATE; }
+
+  s_mmap.fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (s_mmap.fd < 0)
+  {
+    munmap(base, s_mmap.reserve);
+    return ELOG_ERR_INVALID_STATE;
+  }
+  s_mmap.base = (uint8_t *)base;
+  s_mmap.offset = 0;
+  s_mmap.limit = s_mmap.reserve;
+  s_mmap.mapped = 0;
+  s_mmap.dropped = 0;
+  if (!elog_mmap_grow(0u, (s_mmap.chunk < s_mmap.reserve) ? s_mmap.chunk : s_mmap.reserve))
+  {
+    elog_mmap_close();
+    return ELOG_ERR_INVALID_STATE;
+  }
+  return ELOG_ERR_NONE;
+}
+
+/**
+ * @brief Text subscriber: reserve space with one atomic add and copy the line (no syscall unless growing)
+ * @param handle: Unused
+ * @param buf: Message buffer
+ * @param len: Length of message
+ * @return Always 0
+ */
+int elog_mmap_subscriber(int handle, const char *buf, size_t len)
+{
+  (void)handle;
+  if (s_mmap.base == NULL) { return 0; }
+
+  /* Reserve only space that fits: a refused line leaves the offset where it was */
+  size_t off = __atomic_load_n(&s_mmap.offset, __ATOMIC_RELAXED);
+  do
+  {
+    if (off + len > __atomic_load_n(&s_mmap.limit, __ATOMIC_RELAXED))
+    {
+      __atomic_add_fetch(&s_mmap.dropped, 1u, __ATOMIC_RELAXED);
+      return 0;
+    }
+  } while (!__atomic_compare_exchange_n(&s_mmap.offset, &off, off + len, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+  if (off + len > __atomic_load_n(&s_mmap.mapped, __ATOMIC_ACQUIRE) && !elog_mmap_grow(off, off + len))
+  {
+    __atomic_add_fetch(&s_mmap.dropped, 1u, __ATOMIC_RELAXED);
+    return 0;
+  }
+  memcpy(s_mmap.base + off, buf, len);
+  return 0;
+}
+
+/**
+ * @brief Ask the kernel to write mapped pages to storage (durability against power loss)
+ */
+void elog_mmap_sync(void)
+{
+  size_t mapped = __atomic_load_n(&s_mmap.mapped, __ATOMIC_ACQUIRE);
+  if (s_mmap.base != NULL && mapped != 0u) { msync(s_mmap.base, mapped, MS_ASYNC); }
+}
+
+/**
+ * @brief Number of bytes logged so far (excluding dropped lines): the length of the file once closed
+ */
+size_t elog_mmap_size(void)
+{
+  size_t off = __atomic_load_n(&s_mmap.offset, __ATOMIC_RELAXED);
+  size_t limit = __atomic_load_n(&s_mmap.limit, __ATOMIC_RELAXED);
+  return (off < limit) ? off : limit;
+}
+
+/**
+ * @brief Number of lines dropped because the file reached its size limit or could not grow
+ */
+size_t elog_mmap_dropped(void) { return __atomic_load_n(&s_mmap.dropped, __ATOMIC_RELAXED); }
+
+/**
+ * @brief Unmap, trim the preallocated tail and close the file
+ * @note  Unsubscribe first; concurrent writers must be finished.
+ */
+void elog_mmap_close(void)
+{
+  if (s_mmap.base != NULL)
+  {
+    munmap(s_mmap.base, s_mmap.reserve);
+    s_mmap.base = NULL;
+  }
+  if (s_mmap.fd >= 0)
+  {
+    /* Drop the unused part of the last chunk and any space reserved by lines that failed to map
+     * (a crashed process leaves it zero-filled) */
+    size_t used = elog_mmap_size();
+    if (ftruncate(s_mmap.fd, (off_t)used) != 0) { /* keep the zero-filled tail */ }
+    close(s_mmap.fd);
+    s_mmap.fd = -1;
+  }
+}
+#endif
@@ -0,0 +1,51 @@
+/***********************************************************
+ * @file	eLog_modules.h
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Default eLog module list (X-macro)
+ *         Each ELOG_MODULE(name) entry becomes ELOG_MD_<name> in elog_module_t
+ *         and "<name>" for elog_module_name(). Products keep their own list
+ *         out of the library: copy this file, edit the entries, and build
+ *         with -DELOG_MODULES_CONFIG_FILE=\"my_log_modules.h\" (or define
+ *         ELOG_MODULE_LIST before including eLog.h).
+ *         Up to 32 modules with the default 32-bit module mask; define
+ *         ELOG_MODULE_MASK_TYPE as uint64_t for up to 64.
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+#ifndef ELOG_MODULES_H_
+#define ELOG_MODULES_H_
+
+#ifndef ELOG_MODULE_LIST
+#define ELOG_MODULE_LIST(ELOG_MODULE) \
+  ELOG_MODULE(DEFAULT)                \
+  ELOG_MODULE(ERROR)                  \
+  ELOG_MODULE(RNG)                    \
+  ELOG_MODULE(BLE_HOST)               \
+  ELOG_MODULE(BLE_HCI)                \
+  ELOG_MODULE(BLE_LL)                 \
+  ELOG_MODULE(BLE_GATT)               \
+  ELOG_MODULE(BLE_APP)                \
+  ELOG_MODULE(SVCCTL)                 \
+  ELOG_MODULE(P2P_SERVER)             \
+  ELOG_MODULE(BLE_TIMER)              \
+  ELOG_MODULE(SENSOR)                 \
+  ELOG_MODULE(BT)                     \
+  ELOG_MODULE(UI)                     \
+  ELOG_MODULE(FLASH)                  \
+  ELOG_MODULE(BPKA)                   \
+  ELOG_MODULE(AMM)                    \
+  ELOG_MODULE(TEMPMEAS)               \
+  ELOG_MODULE(TX)                     \
+  ELOG_MODULE(HW_PMIC)                \
+  ELOG_MODULE(HW_GPIO)                \
+  ELOG_MODULE(HW_I2C)                 \
+  ELOG_MODULE(HW_SPI)                 \
+  ELOG_MODULE(HW_CURRENT_SENSE)       \
+  ELOG_MODULE(HW_LCD)                 \
+  ELOG_MODULE(APP_PD)
+#endif
+
+#endif
@@ -0,0 +1,311 @@
+/***********************************************************
+ * @file	eLog_persist.c
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Crash-persistent log ring for eLog
+ *         A record subscriber stores binary frames (eLog_bin.c) in a
+ *         byte ring_t that lives in a region surviving reset (.noinit
+ *         RAM on target, a file-backed mmap on Linux). A magic/CRC
+ *         header guards the ring state; a CRC left stale by a reset
+ *         mid-append is repaired by walking the stored frames. After
+ *         reset the surviving frames are handed back by
+ *         elog_persist_recover().
+ *
+ *         Region layout: [elog_persist_hdr_t][frame bytes...]
+ *         Stored frame:  [u16 length, little endian][binary frame]
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+
+#include "eLog.h"
+#include "ring.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define ELOG_PERSIST_MAGIC 0x454C4F47u /* "ELOG" */
+
+/* Largest stored frame: header + full-length message payload */
+#define ELOG_PERSIST_MAX_FRAME (ELOG_BIN_HEADER_MAX + ELOG_FULL_MESSAGE_LENGTH)
+
+/**
+ * @brief Header at the start of the persistent region
+ */
+typedef struct
+{
+  uint32_t magic;
+  uint32_t crc; /* CRC-32 of magic and the ring indices, refreshed after every append */
+  ring_t ring;  /* element_size 1; buffer follows the header */
+} elog_persist_hdr_t;
+
+static elog_persist_hdr_t *s_persist;
+
+/* ========================================================================== */
+/* CRC-32 (IEEE 802.3, nibble table) */
+/* ========================================================================== */
+
+static const uint32_t s_crc_nibble[16] = {
+    0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu, 0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+    0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu, 0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu};
+
+static uint32_t elog_crc32(const void *data, size_t len)
+{
+  const uint8_t *p = (const uint8_t *)data;
+  uint32_t crc = 0xFFFFFFFFu;
+  while (len--)
+  {
+    crc ^= *p++;
+    crc = (crc >> 4) ^ s_crc_nibble[crc & 0x0Fu];
+    crc = (crc >> 4) ^ s_crc_nibble[crc & 0x0Fu];
+  }
+  return ~crc;
+}
+
+/**
+ * @brief CRC over the fields that must be consistent for recovery
+ */
+static uint32_t elog_persist_crc(const elog_persist_hdr_t *hdr)
+{
+  const uint32_t state[5] = {hdr->magic, hdr->ring.size, hdr->ring.head, hdr->ring.tail, hdr->ring.count};
+  return elog_crc32(state, sizeof(state));
+}
+
+/**
+ * @brief Copy n bytes starting at ring offset pos, wrapping at the end of the buffer
+ */
+static void elog_persist_peek(const elog_persist_hdr_t *hdr, uint32_t pos, uint8_t *out, uint32_t n)
+{
+  const uint8_t *data = (const uint8_t *)hdr->ring.buffer;
+  uint32_t first = hdr->ring.size - pos;
+  if (first > n) { first = n; }
+  memcpy(out, data + pos, first);
+  memcpy(out + first, data, n - first);
+}
+
+/**
+ * @brief Rebuild head and count from the frames stored after tail, after a reset hit an append
+ * @note  The CRC is refreshed after the ring indices, and ring_write_multiple() moves head and
+ *        count only after copying the bytes, so a reset mid-append leaves a stale CRC over
+ *        usable frames. tail is trusted, the span up to head is walked frame by frame and cut
+ *        at the first one that does not decode (a partially written newest frame).
+ * @return Number of frames kept
+ */
+static uint32_t elog_persist_rebuild(elog_persist_hdr_t *hdr)
+{
+  ring_t *rb = &hdr->ring;
+  uint32_t span = (rb->head + rb->size - rb->tail) % rb->size;
+  if (span == 0u && rb->count != 0u)
+  {
+    span = rb->size; /* head == tail with data: the ring is (or was just) full */
+  }
+
+  uint32_t frames = 0;
+  uint32_t walked = 0;
+  uint8_t frame[ELOG_PERSIST_MAX_FRAME];
+  while (span - walked >= 2u)
+  {
+    uint8_t len[2];
+    elog_persist_peek(hdr, (rb->tail + walked) % rb->size, len, 2);
+    uint32_t n = (uint32_t)len[0] | ((uint32_t)len[1] << 8);
+    if (n == 0u || n > sizeof(frame) || n > span - walked - 2u)
+    {
+      break;
+    }
+    elog_persist_peek(hdr, (rb->tail + walked + 2u) % rb->size, frame, n);
+
+    elog_bin_state_t state;
+    elog_bin_frame_t decoded;
+    elog_bin_reset(&state);
+    if (elog_bin_decode(&state, frame, n, &decoded) != (int)n)
+    {
+      break;
+    }
+    walked += 2u + n;
+    frames++;
+  }
+
+  rb->count = walked;
+  rb->head = (rb->tail + walked) % rb->size;
+  return frames;
+}
+
+/* ========================================================================== */
+/* Public API */
+/* ========================================================================== */
+
+/**
+ * @brief Attach the persistent region, keeping its contents if the header is intact
+ * @param region: Region surviving reset (ELOG_PERSIST_NOINIT buffer or mmap'd file)
+ * @param region_size: Size of the region in bytes
+ * @return ELOG_ERR_NONE, or ELOG_ERR_INVALID_PARAM if the region is too small
+ */
+elog_err_t elog_persist_init(void *region, size_t region_size)
+{
+  if (region == NULL || region_size <= sizeof(elog_persist_hdr_t) + 2u + ELOG_BIN_HEADER_MAX)
+  {
+    return ELOG_ERR_INVALID_PARAM;
+  }
+
+  elog_persist_hdr_t *hdr = (elog_persist_hdr_t *)region;
+  uint8_t *data = (uint8_t *)region + sizeof(elog_persist_hdr_t);
+  uint32_t data_size = (uint32_t)(region_size - sizeof(elog_persist_hdr_t));
+
+  bool valid = hdr->magic == ELOG_PERSIST_MAGIC && hdr->ring.size == data_size && hdr->ring.head < data_size &&
+               hdr->ring.tail < data_size && hdr->ring.count <= data_size && hdr->ring.element_size == 1u;
+  if (valid)
+  {
+    /* Pointers and handles from the previous run are stale; indices are kept */
+    hdr->ring.buffer = data;
+    hdr->ring.mutex = NULL;
+    hdr->ring.owns_buffer = false;
+    hdr->ring.primask_bit = 0;
+    if (hdr->crc != elog_persist_crc(hdr))
+    {
+      /* Reset during an append: keep every frame that still decodes */
+      (void)elog_persist_rebuild(hdr);
+      hdr->crc = elog_persist_crc(hdr);
+    }
+  }
+  else
+  {
+    ring_init(&hdr->ring, data, data_size, 1);
+    hdr->magic = ELOG_PERSIST_MAGIC;
+    hdr->crc = elog_persist_crc(hdr);
+  }
+  s_persist = hdr;
+  return ELOG_ERR_NONE;
+}
+
+/**
+ * @brief Drop the oldest stored frame
+ * @return false if the ring held nothing to drop
+ */
+static bool elog_persist_evict(ring_t *rb)
+{
+  uint8_t len[2];
+  if (ring_peek_front_multiple(rb, len, 2) != 2u)
+  {
+    ring_clear(rb);
+    return false;
+  }
+  RingBuffer_PopFrontMultiple(rb, 2u + ((uint32_t)len[0] | ((uint32_t)len[1] << 8)));
+  return true;
+}
+
+/**
+ * @brief Store a frame that has to wrap around the end of the ring: encode it aside, then one copy
+ * @note  Out of line so its ELOG_PERSIST_MAX_FRAME-byte buffer is on the stack only on this path,
+ *        taken about once per pass through the ring.
+ */
+static __attribute__((noinline)) void elog_persist_store_wrapped(ring_t *rb, const elog_record_t *rec)
+{
+  uint8_t frame[2u + ELOG_PERSIST_MAX_FRAME];
+  elog_bin_state_t state;
+  elog_bin_reset(&state);
+  size_t n = elog_bin_encode_record(&state, rec, frame + 2, sizeof(frame) - 2u);
+  if (n == 0 || n + 2u > rb->size) { return; }
+  frame[0] = (uint8_t)(n & 0xFFu);
+  frame[1] = (uint8_t)(n >> 8);
+  while (ring_get_free(rb) < n + 2u && elog_persist_evict(rb))
+  {
+  }
+  ring_write_multiple(rb, frame, (uint32_t)(n + 2u));
+}
+
+/**
+ * @brief Record subscriber storing each record as a self-contained binary frame
+ * @note  Oldest frames are evicted to make room. Subscribe with elog_subscribe_record().
+ *        The frame is encoded straight into the ring's free span and published with
+ *        ring_commit(); only a frame wrapping the end of the ring goes through a stack copy.
+ * @param rec: Record to store
+ * @return Always 0
+ */
+int elog_persist_subscriber(const elog_record_t *rec)
+{
+  elog_persist_hdr_t *hdr = s_persist;
+  if (hdr == NULL) { return 0; }
+
+  ring_t *rb = &hdr->ring;
+  for (;;)
+  {
+    /* Every stored frame is a sync frame, so frames stay decodable after older ones are evicted */
+    void *span;
+    uint32_t room = ring_reserve_contiguous(rb, &span);
+    if (room > 2u)
+    {
+      elog_bin_state_t state;
+      elog_bin_reset(&state);
+      uint8_t *out = (uint8_t *)span;
+      size_t n = elog_bin_encode_record(&state, rec, out + 2, room - 2u);
+      if (n != 0u)
+      {
+        /* Bytes first, then head and count (ring_commit), then the CRC: as with ring_write_multiple() */
+        out[0] = (uint8_t)(n & 0xFFu);
+        out[1] = (uint8_t)(n >> 8);
+        ring_commit(rb, (uint32_t)(n + 2u));
+        break;
+      }
+    }
+    if (ring_get_free(rb) > room)
+    {
+      /* Free space continues at the start of the buffer: the frame has to wrap */
+      elog_persist_store_wrapped(rb, rec);
+      break;
+    }
+    if (!elog_persist_evict(rb) && room == rb->size)
+    {
+      break; /* Larger than the whole ring */
+    }
+  }
+  hdr->crc = elog_persist_crc(hdr);
+  return 0;
+}
+
+/**
+ * @brief Number of frame bytes currently held in the persistent ring
+ * @return Bytes, 0 when empty or not initialized
+ */
+uint32_t elog_persist_pending(void)
+{
+  return (s_persist != NULL) ? ring_available(&s_persist->ring) : 0u;
+}
+
+/**
+ * @brief Hand every stored frame to fn, oldest first, and empty the ring
+ * @param fn: Called for each decoded frame
+ * @param ctx: Passed through to fn
+ * @return Number of frames delivered
+ */
+uint32_t elog_persist_recover(elog_persist_visit_t fn, void *ctx)
+{
+  elog_persist_hdr_t *hdr = s_persist;
+  if (hdr == NULL || fn == NULL) { return 0; }
+
+  uint32_t frames = 0;
+  uint8_t frame[ELOG_PERSIST_MAX_FRAME];
+  ring_t *rb = &hdr->ring;
+  while (ring_available(rb) >= 2u)
+  {
+    uint8_t len[2];
+    ring_read_multiple(rb, len, 2);
+    uint32_t n = (uint32_t)len[0] | ((uint32_t)len[1] << 8);
+    if (n > sizeof(frame) || ring_read_multiple(rb, frame, n) != n)
+    {
+      break; // Corrupt length: drop the rest
+    }
+
+    elog_bin_state_t state;
+    elog_bin_frame_t decoded;
+    elog_bin_reset(&state);
+    if (elog_bin_decode(&state, frame, n, &decoded) == (int)n)
+    {
+      fn(&decoded, ctx);
+      frames++;
+    }
+  }
+  ring_clear(rb);
+  hdr->crc = elog_persist_crc(hdr);
+  return frames;
+}
@@ -0,0 +1,175 @@
+/***********************************************************
+ * @file	eLog_queue.c
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Priority-aware log queue for eLog
+ *         A record subscriber sorts text lines into one byte ring_t per
+ *         level band, each with its own reserved capacity, so a flood of
+ *         TRACE can only fill the low lane. elog_queue_drain() runs in the
+ *         log task and always empties the highest non-empty lane first;
+ *         when the output (e.g. the console ring_tx) is busy the line
+ *         stays queued and is retried on the next drain.
+ *
+ *         Lane storage: [lane 0 bytes][lane 1 bytes][lane 2 bytes]
+ *         Stored line:  [u16 length, little endian][text]
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+
+#include "eLog.h"
+#include "ring.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+static ring_t s_lanes[ELOG_QUEUE_LANES];
+static elog_queue_stats_t s_queue_stats;
+static bool s_queue_ready;
+
+/**
+ * @brief Lane serving a level: 0 = CRITICAL and above, 1 = WARNING/ERROR, 2 = the rest
+ */
+static inline uint32_t elog_queue_lane(elog_level_t level)
+{
+  if ((unsigned)level >= (unsigned)ELOG_QUEUE_HIGH_LEVEL) { return 0u; }
+  if ((unsigned)level >= (unsigned)ELOG_QUEUE_MID_LEVEL) { return 1u; }
+  return 2u;
+}
+
+/* ========================================================================== */
+/* Public API */
+/* ========================================================================== */
+
+/**
+ * @brief Carve the lanes out of one storage block
+ * @param storage: Lane storage, at least the sum of lane_bytes, must outlive the queue
+ * @param lane_bytes: Reserved bytes per lane, highest priority first (0 drops the band)
+ * @return ELOG_ERR_NONE, or ELOG_ERR_INVALID_PARAM
+ */
+elog_err_t elog_queue_init(uint8_t *storage, const uint32_t lane_bytes[ELOG_QUEUE_LANES])
+{
+  if (storage == NULL || lane_bytes == NULL)
+  {
+    return ELOG_ERR_INVALID_PARAM;
+  }
+
+  s_queue_ready = false;
+  for (uint32_t i = 0; i < ELOG_QUEUE_LANES; i++)
+  {
+    ring_init(&s_lanes[i], storage, lane_bytes[i], 1);
+    storage += lane_bytes[i];
+  }
+  memset(&s_queue_stats, 0, sizeof(s_queue_stats));
+  s_queue_ready = true;
+  return ELOG_ERR_NONE;
+}
+
+/**
+ * @brief Record subscriber queueing the text line in the lane of its level
+ * @note  A line that does not fit its lane is dropped; other lanes are never borrowed,
+ *        so higher bands keep their reserved room. Subscribe with elog_subscribe_record().
+ * @param rec: Record to queue
+ * @return 0 if queued, -1 if dropped
+ */
+int elog_queue_subscriber(const elog_record_t *rec)
+{
+  if (!s_queue_ready || rec == NULL)
+  {
+    return -1;
+  }
+
+  uint32_t lane = elog_queue_lane(rec->level);
+  ring_t *rb = &s_lanes[lane];
+  size_t len = 0;
+  const char *text = elog_record_text(rec, &len);
+
+  /* Lanes have a single producer (records are delivered under the log mutex) and the
+   * drain only frees room, so the free-space check holds until the write */
+  uint8_t frame[2u + ELOG_FULL_MESSAGE_LENGTH];
+  if (text == NULL || len == 0u || len > ELOG_FULL_MESSAGE_LENGTH || ring_get_free(rb) < len + 2u)
+  {
+    s_queue_stats.dropped[lane]++;
+    return -1;
+  }
+  frame[0] = (uint8_t)(len & 0xFFu);
+  frame[1] = (uint8_t)(len >> 8);
+  memcpy(frame + 2, text, len);
+  ring_write_multiple(rb, frame, (uint32_t)(len + 2u));
+
+  s_queue_stats.queued[lane]++;
+  uint32_t used = ring_available(rb);
+  if (used > s_queue_stats.high_water[lane])
+  {
+    s_queue_stats.high_water[lane] = used;
+  }
+  return 0;
+}
+
+/**
+ * @brief Hand queued lines to an output, highest lane first
+ * @param out: Output taking one line per call (e.g. elog_console_subscriber); a return
+ *             value < 0 means busy: the line stays queued and the drain stops
+ * @param max_records: Upper bound on lines written by this call, 0 for all
+ * @return Number of lines written
+ */
+uint32_t elog_queue_drain(log_subscriber_t out, uint32_t max_records)
+{
+  if (!s_queue_ready || out == NULL)
+  {
+    return 0;
+  }
+
+  uint32_t written = 0;
+  uint32_t lane = 0;
+  char line[2u + ELOG_FULL_MESSAGE_LENGTH];
+  while (lane < ELOG_QUEUE_LANES && (max_records == 0u || written < max_records))
+  {
+    ring_t *rb = &s_lanes[lane];
+    uint8_t hdr[2];
+    if (ring_peek_front_multiple(rb, hdr, 2) != 2u)
+    {
+      lane++; // Lane empty: move down one band
+      continue;
+    }
+    uint32_t n = (uint32_t)hdr[0] | ((uint32_t)hdr[1] << 8);
+    if (n > ELOG_FULL_MESSAGE_LENGTH || ring_peek_front_multiple(rb, line, n + 2u) != n + 2u)
+    {
+      ring_clear(rb); // Corrupt length: drop the lane
+      continue;
+    }
+    if (out(1, line + 2, n) < 0)
+    {
+      s_queue_stats.busy++;
+      break; // Output full: keep the line for the next drain
+    }
+    RingBuffer_PopFrontMultiple(rb, n + 2u);
+    s_queue_stats.delivered[lane]++;
+    written++;
+    lane = 0; // A higher lane may have refilled while the output ran
+  }
+  return written;
+}
+
+/**
+ * @brief Bytes queued in one lane
+ * @param lane: 0 (highest priority) to ELOG_QUEUE_LANES - 1
+ * @return Bytes, 0 when empty, out of range or not initialized
+ */
+uint32_t elog_queue_pending(uint32_t lane)
+{
+  return (s_queue_ready && lane < ELOG_QUEUE_LANES) ? ring_available(&s_lanes[lane]) : 0u;
+}
+
+/**
+ * @brief Snapshot the per-lane counters
+ * @param stats: Output
+ */
+void elog_queue_get_stats(elog_queue_stats_t *stats)
+{
+  if (stats != NULL)
+  {
+    *stats = s_queue_stats;
+  }
+}
@@ -0,0 +1,136 @@
+/***********************************************************
+ * @file	eLog_trace.c
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Chrome trace export for eLog binary frames
+ *         Host-side converter: frames decoded with elog_bin_decode()
+ *         become Trace Event Format objects that chrome://tracing and
+ *         ui.perfetto.dev load directly. Span frames map to "B"/"E"
+ *         duration events, text frames to instant events; each module
+ *         is one thread track.
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+
+#include "eLog.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Append a JSON string literal (quotes included), escaping as needed
+ * @return New position, or size if out is too small
+ */
+static size_t elog_trace_put_str(char *out, size_t size, size_t pos, const char *str, size_t len)
+{
+  static const char hex[] = "0123456789abcdef";
+  if (pos + 1u >= size) { return size; }
+  out[pos++] = '"';
+  for (size_t i = 0; i < len; i++)
+  {
+    unsigned char c = (unsigned char)str[i];
+    if (c == '"' || c == '\\')
+    {
+      if (pos + 2u >= size) { return size; }
+      out[pos++] = '\\';
+      out[pos++] = (char)c;
+    }
+    else if (c < 0x20u)
+    {
+      if (pos + 6u >= size) { return size; }
+      memcpy(out + pos, "\\u00", 4);
+      out[pos + 4] = hex[c >> 4];
+      out[pos + 5] = hex[c & 0x0Fu];
+      pos += 6u;
+    }
+    else
+    {
+      if (pos + 1u >= size) { return size; }
+      out[pos++] = (char)c;
+    }
+  }
+  if (pos + 1u >= size) { return size; }
+  out[pos++] = '"';
+  return pos;
+}
+
+/* ========================================================================== */
+/* Public API */
+/* ========================================================================== */
+
+/**
+ * @brief Start a conversion
+ * @param tj: Converter state
+ * @param ts_rate: Timestamp ticks per second of the capturing target
+ */
+void elog_trace_json_init(elog_trace_json_t *tj, uint32_t ts_rate)
+{
+  if (tj == NULL) { return; }
+  memset(tj, 0, sizeof(*tj));
+  tj->ts_rate = (ts_rate != 0u) ? ts_rate : 1000000u;
+}
+
+/**
+ * @brief Render one decoded frame as a Chrome trace event object
+ * @param tj: Converter state
+ * @param frame: Frame from elog_bin_decode(), with a timestamp
+ * @param out: Destination
+ * @param size: Destination size
+ * @return Length written, 0 if the frame has no trace representation, -1 if out is too small
+ */
+int elog_trace_json_event(elog_trace_json_t *tj, const elog_bin_frame_t *frame, char *out, size_t size)
+{
+  if (tj == NULL || frame == NULL || out == NULL || !frame->has_timestamp) { return 0; }
+
+  const char *name;
+  uint32_t name_len;
+  uint32_t span_ticks;
+  uint8_t phase;
+  if (frame->payload_type == ELOG_BIN_PAYLOAD_SPAN)
+  {
+    if (elog_bin_span_open(frame, &phase, &span_ticks, &name, &name_len) != 0) { return 0; }
+  }
+  else if (frame->payload_type == ELOG_BIN_PAYLOAD_TEXT)
+  {
+    phase = 'i';
+    name = (const char *)frame->payload;
+    name_len = (uint32_t)frame->payload_len;
+  }
+  else
+  {
+    return 0;
+  }
+
+  /* 32-bit target ticks: a step backwards is a wrap-around */
+  if (tj->started && frame->timestamp < tj->last_ts) { tj->wraps += 0x100000000ull; }
+  tj->started = true;
+  tj->last_ts = frame->timestamp;
+  double us = (double)(tj->wraps + frame->timestamp) * 1e6 / (double)tj->ts_rate;
+
+  size_t pos = 0;
+  int n = snprintf(out, size, "{\"name\":");
+  if (n < 0 || (size_t)n >= size) { return -1; }
+  pos = elog_trace_put_str(out, size, (size_t)n, name, name_len);
+  if (pos >= size) { return -1; }
+  n = snprintf(out + pos, size - pos, ",\"cat\":\"%s\",\"ph\":\"%c\",%s\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+               elog_level_name(frame->level), (char)phase, (phase == 'i') ? "\"s\":\"t\"," : "", us,
+               (unsigned)frame->module);
+  if (n < 0 || (size_t)n >= size - pos) { return -1; }
+  return (int)(pos + (size_t)n);
+}
+
+/**
+ * @brief Render the metadata event naming a module's track
+ * @param module: Module identifier
+ * @param out: Destination
+ * @param size: Destination size
+ * @return Length written, -1 if out is too small
+ */
+int elog_trace_json_module(elog_module_t module, char *out, size_t size)
+{
+  if (out == NULL) { return -1; }
+  int n = snprintf(out, size, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                   (unsigned)module, elog_module_name(module));
+  return (n < 0 || (size_t)n >= size) ? -1 : n;
+}
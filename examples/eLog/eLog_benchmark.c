@@ -0,0 +1,944 @@
+/***********************************************************
+ * @file	eLog_benchmark.c
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Host benchmark suite for the eLog hot paths
+ *
+ *         Build and run on the host (from the repository root):
+ *           gcc -O2 -pthread -I. -IeLog -Iring examples/eLog/eLog_benchmark.c eLog/eLog.c eLog/eLog_fmt.c \
+ *               eLog/eLog_bin.c eLog/eLog_persist.c eLog/eLog_queue.c eLog/eLog_file.c eLog/eLog_mmap.c ring/ring.c \
+ *               common.c -o elog_bench
+ *           ./elog_bench
+ *
+ *         The run first checks the built-in formatter's %f/%e/%g output against libc
+ *         and exits non-zero on any mismatch.
+ *
+ *         On Cortex-M targets the same file can be linked into a test image;
+ *         bench_now() then reads the DWT cycle counter.
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+
+#include "eLog.h"
+#include "ring.h"
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#if !defined(__arm__)
+#include <time.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define BENCH_HAVE_FILES 1
+#endif
+
+#define BENCH_ITERATIONS 200000u
+
+/* ========================================================================== */
+/* Timing helpers */
+/* ========================================================================== */
+
+/**
+ * @brief Read a monotonic cycle (or nanosecond) counter
+ * @retval Cycles on x86 (TSC) and Cortex-M (DWT->CYCCNT), nanoseconds elsewhere
+ */
+static inline uint64_t bench_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#elif defined(__arm__)
+  return *(volatile uint32_t *)0xE0001004u; /* DWT->CYCCNT */
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+#ifndef BENCH_CLOCK_HZ
+#define BENCH_CLOCK_HZ 64000000u /* bench_now() rate where there is no monotonic clock (e.g. core clock) */
+#endif
+
+#if !defined(__unix__) && !defined(__APPLE__)
+static uint32_t bench_clock_ticks(void) { return (uint32_t)bench_now(); }
+#endif
+
+/**
+ * @brief Install the timestamp source of the timestamped sections
+ * @note  CLOCK_MONOTONIC on POSIX hosts, bench_now() at BENCH_CLOCK_HZ elsewhere (DWT on Cortex-M)
+ */
+static void bench_use_clock(void)
+{
+#if defined(__unix__) || defined(__APPLE__)
+  elog_timestamp_use_monotonic_clock();
+#else
+  elog_set_timestamp_source(bench_clock_ticks, BENCH_CLOCK_HZ);
+#endif
+}
+
+static void bench_report(const char *name, uint64_t ticks, uint32_t iterations)
+{
+  printf("%-40s %10.1f ticks/call\n", name, (double)ticks / (double)iterations);
+}
+
+/* ========================================================================== */
+/* Sinks */
+/* ========================================================================== */
+
+/* Console subscriber backend; the benchmark discards everything */
+int LPUartQueueBuffWrite(int handle, const char *buf, size_t bufSize)
+{
+  (void)handle;
+  (void)buf;
+  return (int)bufSize;
+}
+
+static volatile size_t s_sink_bytes;
+
+static int bench_null_subscriber(int handle, const char *buf, size_t len)
+{
+  (void)handle;
+  (void)buf;
+  s_sink_bytes += len;
+  return 0;
+}
+
+/* ========================================================================== */
+/* Formatting: single pass vs. legacy double pass */
+/* ========================================================================== */
+
+/* Replica of the pre-0.07 elog_message formatting: clear both buffers, splice the
+ * user format into a prefix format, then expand the combined format string. */
+static char s_legacy_fmt[ELOG_MAX_MESSAGE_LENGTH];
+static char s_legacy_full[ELOG_FULL_MESSAGE_LENGTH];
+static uint32_t s_legacy_nbr;
+
+static int legacy_message(elog_module_t module, elog_level_t level, const char *fmt, ...)
+{
+  memset(s_legacy_fmt, 0, sizeof(s_legacy_fmt));
+  memset(s_legacy_full, 0, sizeof(s_legacy_full));
+  snprintf(s_legacy_fmt, sizeof(s_legacy_fmt), "%s%s:%u,%" PRIu32 ": %s%s\n", LOG_COLOR(LOG_COLOR_RED),
+           elog_level_name(level), (uint8_t)module, ++s_legacy_nbr, fmt, LOG_RESET_COLOR);
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(s_legacy_full, sizeof(s_legacy_full), s_legacy_fmt, args);
+  va_end(args);
+  bench_null_subscriber(1, s_legacy_full, (size_t)len);
+  return len;
+}
+
+static void bench_format_single_pass(void)
+{
+  uint64_t start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    legacy_message(ELOG_MD_SENSOR, ELOG_LEVEL_ERROR, "sensor %u read failed: status=0x%02X", i, 0x5Au);
+  }
+  uint64_t legacy = bench_now() - start;
+
+  start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    elog_message(ELOG_MD_SENSOR, ELOG_LEVEL_ERROR, "sensor %u read failed: status=0x%02X", i, 0x5Au);
+  }
+  uint64_t single = bench_now() - start;
+
+  bench_report("format: legacy double pass + memset", legacy, BENCH_ITERATIONS);
+  bench_report("format: single pass (elog_message)", single, BENCH_ITERATIONS);
+  printf("%-40s %10.1f ticks/call\n", "format: saved", ((double)legacy - (double)single) / BENCH_ITERATIONS);
+}
+
+/* ========================================================================== */
+/* Formatter: built-in engine vs. libc */
+/* ========================================================================== */
+
+static int bench_libc_format(char *buf, size_t size, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(buf, size, fmt, args);
+  va_end(args);
+  return len;
+}
+
+static void bench_formatter(void)
+{
+  static const struct
+  {
+    const char *name;
+    const char *fmt;
+  } cases[] = {
+      {"%u/%d", "seq=%u delta=%d"},
+      {"%08X", "reg=0x%08X"},
+      {"%s", "state=%s"},
+      {"%.2f", "temp=%.2f"},
+  };
+  char buf[ELOG_FULL_MESSAGE_LENGTH];
+
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+  {
+    char name[48];
+    uint64_t libc_ticks = 0;
+    uint64_t elog_ticks = 0;
+    for (int pass = 0; pass < 2; pass++)
+    {
+      int (*fn)(char *, size_t, const char *, ...) = pass ? elog_snprintf : bench_libc_format;
+      uint64_t start = bench_now();
+      for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+      {
+        switch (c)
+        {
+        case 0: fn(buf, sizeof(buf), cases[c].fmt, i, -(int)i); break;
+        case 1: fn(buf, sizeof(buf), cases[c].fmt, i * 2654435761u); break;
+        case 2: fn(buf, sizeof(buf), cases[c].fmt, (i & 1) ? "CONNECTED" : "IDLE"); break;
+        default: fn(buf, sizeof(buf), cases[c].fmt, (double)i * 0.01); break;
+        }
+      }
+      uint64_t ticks = bench_now() - start;
+      if (pass) { elog_ticks = ticks; }
+      else { libc_ticks = ticks; }
+    }
+    snprintf(name, sizeof(name), "fmt %-6s libc vsnprintf", cases[c].name);
+    bench_report(name, libc_ticks, BENCH_ITERATIONS);
+    snprintf(name, sizeof(name), "fmt %-6s elog_vsnprintf", cases[c].name);
+    bench_report(name, elog_ticks, BENCH_ITERATIONS);
+  }
+}
+
+/**
+ * @brief Check the built-in engine against libc on %f conversions (rounding, flags, widths)
+ * @return Number of mismatches
+ */
+static uint32_t bench_formatter_check(void)
+{
+  static const struct
+  {
+    const char *fmt;
+    double v;
+  } cases[] = {
+      {"%.0f", 0.5},    {"%.0f", 1.5},     {"%.0f", 2.5},     {"%.0f", 3.5},    {"%.0f", -1.5},
+      {"%.0f", -2.5},   {"%.0f", 2.4999},  {"%#.0f", 1.5},    {"%.1f", 0.25},   {"%.1f", 0.35},
+      {"%.2f", 2.675},  {"%.2f", 1.005},   {"%.2f", 0.125},   {"%.3f", 9.9995}, {"%f", 3.14159265},
+      {"%f", -0.0},     {"%.2f", 99.995},  {"%8.3f", -1.5},   {"%-8.1f|", 2.25}, {"%+.2f", 0.0},
+      {"%08.2f", -3.5}, {"% .1f", 7.05},   {"%.4f", 1e10},    {"%.6f", 1e-7},   {"%.0f", 4503599627370497.0},
+      {"%.2f", 1e23},   {"%e", 3.14},      {"%.0e", 2.5},     {"%.3E", -1e-300}, {"%.16e", 0.1},
+      {"%g", 3.14},     {"%g", 3.14f},     {"%g", 1e-5},      {"%g", 1.2e8},    {"%.17g", 5e-324},
+      {"%#g", 2.0},     {"%.3g", 1.235e-4}, {"%G", 1e300},    {"%10.4g|", 99.995}, {"%g", 0.0},
+  };
+  char expect[64];
+  char got[64];
+  uint32_t mismatches = 0;
+
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+  {
+    bench_libc_format(expect, sizeof(expect), cases[c].fmt, cases[c].v);
+    elog_snprintf(got, sizeof(got), cases[c].fmt, cases[c].v);
+    if (strcmp(expect, got) != 0)
+    {
+      printf("fmt check: \"%s\" of %.17g: libc \"%s\", elog \"%s\"\n", cases[c].fmt, cases[c].v, expect, got);
+      mismatches++;
+    }
+  }
+  printf("%-40s %10u / %u cases differ from libc\n", "fmt check: %f/%e/%g conversions", (unsigned)mismatches,
+         (unsigned)(sizeof(cases) / sizeof(cases[0])));
+  return mismatches;
+}
+
+/* ========================================================================== */
+/* Disabled statements: inline rejection vs. function call */
+/* ========================================================================== */
+
+static uint32_t bench_expensive_arg(uint32_t i)
+{
+  /* Stands in for an argument that is costly to evaluate (e.g. a register read) */
+  s_sink_bytes += i;
+  return i * 3u;
+}
+
+static void bench_disabled_statement(void)
+{
+  elog_set_module_threshold(ELOG_MD_BLE_LL, ELOG_LEVEL_ERROR);
+
+  uint64_t start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    /* Direct call: argument evaluation + call + threshold test inside eLog */
+    elog_message(ELOG_MD_BLE_LL, ELOG_LEVEL_DEBUG, "conn evt %u", bench_expensive_arg(i));
+  }
+  uint64_t called = bench_now() - start;
+
+  start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    ELOG_DEBUG(ELOG_MD_BLE_LL, "conn evt %u", bench_expensive_arg(i));
+  }
+  uint64_t inlined = bench_now() - start;
+
+  bench_report("disabled: elog_message call", called, BENCH_ITERATIONS);
+  bench_report("disabled: ELOG_DEBUG inline reject", inlined, BENCH_ITERATIONS);
+  elog_set_module_threshold(ELOG_MD_BLE_LL, ELOG_LEVEL_TRACE);
+}
+
+/* ========================================================================== */
+/* Runtime level control: lock-free per-module stores */
+/* ========================================================================== */
+
+static void bench_level_control(void)
+{
+  uint64_t start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    elog_set_module_threshold(ELOG_MD_SENSOR, (i & 1u) ? ELOG_LEVEL_TRACE : ELOG_LEVEL_ERROR);
+  }
+  uint64_t single = bench_now() - start;
+
+  start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS / 10u; i++)
+  {
+    elog_set_levels_str((i & 1u) ? "*=T" : "*=E,11=T");
+  }
+  uint64_t command = bench_now() - start;
+
+  bench_report("levels: elog_set_module_threshold", single, BENCH_ITERATIONS);
+  bench_report("levels: elog_set_levels_str all modules", command, BENCH_ITERATIONS / 10u);
+  elog_set_levels_str("*=T");
+}
+
+/* ========================================================================== */
+/* Module-masked subscribers: records nobody wants are never formatted */
+/* ========================================================================== */
+
+static void bench_unwanted_record(void)
+{
+  LOG_UNSUBSCRIBE(bench_null_subscriber);
+  elog_subscribe_ex(bench_null_subscriber, ELOG_LEVEL_ERROR, ELOG_MODULE_BIT(ELOG_MD_FLASH) | ELOG_MODULE_BIT(ELOG_MD_HW_PMIC));
+
+  uint64_t start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    ELOG_ERROR(ELOG_MD_UI, "touch %u ignored", i);
+  }
+  uint64_t unwanted = bench_now() - start;
+  bench_report("unwanted: module not in any mask", unwanted, BENCH_ITERATIONS);
+
+  LOG_SUBSCRIBE(bench_null_subscriber, ELOG_LEVEL_TRACE);
+}
+
+/* ========================================================================== */
+/* Binary frames: record subscriber with delta-encoded timestamps vs. text */
+/* ========================================================================== */
+
+static elog_bin_state_t s_bin_state;
+static uint8_t s_bin_frame[ELOG_FULL_MESSAGE_LENGTH];
+
+static int bench_binary_subscriber(const elog_record_t *rec)
+{
+  s_sink_bytes += elog_bin_encode_record(&s_bin_state, rec, s_bin_frame, sizeof(s_bin_frame));
+  return 0;
+}
+
+static void bench_binary_frames(void)
+{
+  bench_use_clock();
+
+  /* elog_message() rather than ELOG_ERROR: with ELOG_RATELIMIT_ENABLE the statement's token
+   * bucket would pass only its burst, and the section would measure the limiter */
+  s_sink_bytes = 0;
+  uint64_t start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    elog_message(ELOG_MD_SENSOR, ELOG_LEVEL_ERROR, "adc %u", i & 0xFFu);
+  }
+  uint64_t text = bench_now() - start;
+  double text_bytes = (double)s_sink_bytes / BENCH_ITERATIONS;
+
+  LOG_UNSUBSCRIBE(bench_null_subscriber);
+  LOG_SUBSCRIBE_RECORD(bench_binary_subscriber, ELOG_LEVEL_TRACE);
+  elog_bin_reset(&s_bin_state);
+  s_sink_bytes = 0;
+  start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    elog_message(ELOG_MD_SENSOR, ELOG_LEVEL_ERROR, "adc %u", i & 0xFFu);
+  }
+  uint64_t binary = bench_now() - start;
+  double binary_bytes = (double)s_sink_bytes / BENCH_ITERATIONS;
+
+  bench_report("timestamped: text subscriber", text, BENCH_ITERATIONS);
+  bench_report("timestamped: binary frame subscriber", binary, BENCH_ITERATIONS);
+  printf("%-40s %10.1f / %.1f bytes/record\n", "timestamped: text / binary size", text_bytes, binary_bytes);
+
+  LOG_UNSUBSCRIBE_RECORD(bench_binary_subscriber);
+  LOG_SUBSCRIBE(bench_null_subscriber, ELOG_LEVEL_TRACE);
+  elog_set_timestamp_source(NULL, 0);
+}
+
+/* ========================================================================== */
+/* Log storms: per-call-site token bucket */
+/* ========================================================================== */
+
+static void bench_storm(void)
+{
+  /* Same expansion as an ELOG_* statement built with ELOG_RATELIMIT_ENABLE = YES */
+  static elog_ratelimit_t site = {.line = (uint16_t)__LINE__};
+  bench_use_clock();
+
+  uint64_t start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    elog_message(ELOG_MD_SENSOR, ELOG_LEVEL_ERROR, "i2c nak %u", bench_expensive_arg(i));
+  }
+  uint64_t unlimited = bench_now() - start;
+
+  start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    if (elog_ratelimit_pass(&site, ELOG_MD_SENSOR, ELOG_LEVEL_ERROR))
+    {
+      elog_message(ELOG_MD_SENSOR, ELOG_LEVEL_ERROR, "i2c nak %u", bench_expensive_arg(i));
+    }
+  }
+  uint64_t limited = bench_now() - start;
+
+  bench_report("storm: unlimited", unlimited, BENCH_ITERATIONS);
+  bench_report("storm: rate-limited call site", limited, BENCH_ITERATIONS);
+  elog_set_timestamp_source(NULL, 0);
+}
+
+/* ========================================================================== */
+/* Steady-state error loop: duplicate coalescing (build with -DELOG_COALESCE_ENABLE=YES) */
+/* ========================================================================== */
+
+static void bench_repeated(void)
+{
+  bench_use_clock();
+  s_sink_bytes = 0;
+
+  /* Not ELOG_ERROR: a rate-limited build would drop the loop before coalescing sees it */
+  uint64_t start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    elog_message(ELOG_MD_FLASH, ELOG_LEVEL_ERROR, "erase failed: sector %u status 0x%02X", 12u, 0x81u);
+  }
+  uint64_t ticks = bench_now() - start;
+  elog_coalesce_flush();
+
+  bench_report((ELOG_COALESCE_ENABLE == YES) ? "repeated: coalescing on" : "repeated: coalescing off", ticks,
+               BENCH_ITERATIONS);
+  printf("%-40s %10.1f bytes/call\n", "repeated: sink traffic", (double)s_sink_bytes / BENCH_ITERATIONS);
+  elog_set_timestamp_source(NULL, 0);
+}
+
+/* ========================================================================== */
+/* TRACE sensor loop: full vs. 1-in-16 sampling (build with -DELOG_SAMPLING_ENABLE=YES) */
+/* ========================================================================== */
+
+static void bench_sampling(void)
+{
+  bench_use_clock();
+  elog_set_module_sampling(ELOG_MD_TEMPMEAS, 16, ELOG_SAMPLE_EVERY_NTH);
+  s_sink_bytes = 0;
+
+  uint64_t start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    elog_message(ELOG_MD_TEMPMEAS, ELOG_LEVEL_TRACE, "adc ch%u raw %u", i & 3u, i & 0xFFFu);
+  }
+  uint64_t ticks = bench_now() - start;
+
+  bench_report((ELOG_SAMPLING_ENABLE == YES) ? "trace loop: sampled 1 in 16" : "trace loop: sampling off", ticks,
+               BENCH_ITERATIONS);
+  printf("%-40s %10.1f bytes/call\n", "trace loop: sink traffic", (double)s_sink_bytes / BENCH_ITERATIONS);
+  elog_set_module_sampling(ELOG_MD_TEMPMEAS, 1, ELOG_SAMPLE_EVERY_NTH);
+  elog_set_timestamp_source(NULL, 0);
+}
+
+/* ========================================================================== */
+/* Interrupt handler logging: capture cost vs. a formatted call               */
+/* (build with -DELOG_ISR_ENABLE=YES                                          */
+/*  -D'ELOG_IN_ISR()=({ extern volatile int bench_in_isr; bench_in_isr; })') */
+/* ========================================================================== */
+
+volatile int bench_in_isr;
+
+static void bench_isr(void)
+{
+  uint64_t task = 0;
+  uint64_t capture = 0;
+  uint64_t drain = 0;
+  bench_use_clock();
+
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i += ELOG_ISR_QUEUE_LEN)
+  {
+    uint64_t start = bench_now();
+    for (uint32_t k = 0; k < ELOG_ISR_QUEUE_LEN; k++)
+    {
+      elog_message(ELOG_MD_HW_SPI, ELOG_LEVEL_ERROR, "rx overrun sr=0x%04X cnt=%u", 0x0828u, i + k);
+    }
+    task += bench_now() - start;
+
+    bench_in_isr = 1;
+    start = bench_now();
+    for (uint32_t k = 0; k < ELOG_ISR_QUEUE_LEN; k++)
+    {
+      elog_message(ELOG_MD_HW_SPI, ELOG_LEVEL_ERROR, "rx overrun sr=0x%04X cnt=%u", 0x0828u, i + k);
+    }
+    capture += bench_now() - start;
+    bench_in_isr = 0;
+
+    start = bench_now();
+    elog_isr_drain(0);
+    drain += bench_now() - start;
+  }
+
+  bench_report("isr: formatted call (task context)", task, BENCH_ITERATIONS);
+  bench_report((ELOG_ISR_ENABLE == YES) ? "isr: deferred capture" : "isr: capture (fast path off)", capture,
+               BENCH_ITERATIONS);
+  bench_report("isr: elog_isr_drain() per record", drain, BENCH_ITERATIONS);
+  elog_set_timestamp_source(NULL, 0);
+}
+
+/* ========================================================================== */
+/* Buffer logging: one record per byte vs. ELOG_HEXDUMP */
+/* ========================================================================== */
+
+#define BENCH_PACKET_LEN 64u
+#define BENCH_PACKETS    (BENCH_ITERATIONS / 100u)
+
+static void bench_hexdump(void)
+{
+  uint8_t packet[BENCH_PACKET_LEN];
+  for (uint32_t i = 0; i < BENCH_PACKET_LEN; i++)
+  {
+    packet[i] = (uint8_t)(i * 37u);
+  }
+
+  uint64_t start = bench_now();
+  for (uint32_t n = 0; n < BENCH_PACKETS; n++)
+  {
+    for (uint32_t i = 0; i < BENCH_PACKET_LEN; i++)
+    {
+      elog_message(ELOG_MD_BLE_HCI, ELOG_LEVEL_ERROR, "%02X", packet[i]);
+    }
+  }
+  uint64_t per_byte = bench_now() - start;
+
+  start = bench_now();
+  for (uint32_t n = 0; n < BENCH_PACKETS; n++)
+  {
+    ELOG_HEXDUMP(ELOG_MD_BLE_HCI, ELOG_LEVEL_ERROR, packet, sizeof(packet));
+  }
+  uint64_t dump = bench_now() - start;
+
+  char hex[BENCH_PACKET_LEN * 3];
+  start = bench_now();
+  for (uint32_t n = 0; n < BENCH_ITERATIONS; n++)
+  {
+    packet[0] = (uint8_t)n;
+    s_sink_bytes += elog_hex_encode(hex, packet, sizeof(packet), ' ');
+  }
+  uint64_t encode = bench_now() - start;
+
+  bench_report("hexdump 64 B: record per byte", per_byte, BENCH_PACKETS);
+  bench_report("hexdump 64 B: ELOG_HEXDUMP", dump, BENCH_PACKETS);
+  bench_report("hexdump 64 B: elog_hex_encode only", encode, BENCH_ITERATIONS);
+}
+
+/* ========================================================================== */
+/* Structured records: printf text vs. ELOG_KV, text and binary sinks */
+/* ========================================================================== */
+
+static void bench_kv(void)
+{
+  s_sink_bytes = 0;
+  uint64_t start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    elog_message(ELOG_MD_SENSOR, ELOG_LEVEL_ERROR, "temp_read temp=%d volt=%u", -(int)(i & 0x1Fu), 3300u + (i & 7u));
+  }
+  uint64_t text = bench_now() - start;
+  double text_bytes = (double)s_sink_bytes / BENCH_ITERATIONS;
+
+  s_sink_bytes = 0;
+  start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    ELOG_KV(ELOG_MD_SENSOR, ELOG_LEVEL_ERROR, "temp_read", ELOG_I32("temp", -(int)(i & 0x1Fu)),
+            ELOG_U32("volt", 3300u + (i & 7u)));
+  }
+  uint64_t kv_text = bench_now() - start;
+  double kv_text_bytes = (double)s_sink_bytes / BENCH_ITERATIONS;
+
+  LOG_UNSUBSCRIBE(bench_null_subscriber);
+  LOG_SUBSCRIBE_RECORD(bench_binary_subscriber, ELOG_LEVEL_TRACE);
+  elog_bin_reset(&s_bin_state);
+  s_sink_bytes = 0;
+  start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    ELOG_KV(ELOG_MD_SENSOR, ELOG_LEVEL_ERROR, "temp_read", ELOG_I32("temp", -(int)(i & 0x1Fu)),
+            ELOG_U32("volt", 3300u + (i & 7u)));
+  }
+  uint64_t kv_binary = bench_now() - start;
+  double kv_binary_bytes = (double)s_sink_bytes / BENCH_ITERATIONS;
+  LOG_UNSUBSCRIBE_RECORD(bench_binary_subscriber);
+  LOG_SUBSCRIBE(bench_null_subscriber, ELOG_LEVEL_TRACE);
+
+  bench_report("kv: printf text", text, BENCH_ITERATIONS);
+  bench_report("kv: ELOG_KV text subscriber", kv_text, BENCH_ITERATIONS);
+  bench_report("kv: ELOG_KV binary subscriber", kv_binary, BENCH_ITERATIONS);
+  printf("%-40s %6.1f / %.1f / %.1f bytes/record\n", "kv: printf / kv text / kv binary", text_bytes, kv_text_bytes,
+         kv_binary_bytes);
+}
+
+/* ========================================================================== */
+/* Trace spans: ELOG_SPAN pair vs. hand-written enter/exit lines */
+/* ========================================================================== */
+
+static volatile uint32_t s_span_work;
+
+static void bench_span_work(uint32_t i)
+{
+  ELOG_SPAN_SCOPE(ELOG_MD_SENSOR, "sensor_read");
+  s_span_work = i;
+}
+
+static void bench_span(void)
+{
+  bench_use_clock();
+  const uint32_t rate = elog_get_timestamp_rate();
+
+  /* The call number keeps the enter lines distinct, so a coalescing build does not fold them */
+  s_sink_bytes = 0;
+  uint64_t start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    uint64_t enter = bench_now();
+    elog_message(ELOG_MD_SENSOR, ELOG_LEVEL_TRACE, "enter %s #%u", "sensor_read", i);
+    s_span_work = i;
+    elog_message(ELOG_MD_SENSOR, ELOG_LEVEL_TRACE, "exit %s %u ticks", "sensor_read",
+                 (unsigned)(bench_now() - enter));
+  }
+  uint64_t manual = bench_now() - start;
+  double manual_bytes = (double)s_sink_bytes / BENCH_ITERATIONS;
+
+  s_sink_bytes = 0;
+  start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    bench_span_work(i);
+  }
+  uint64_t span_text = bench_now() - start;
+  double span_text_bytes = (double)s_sink_bytes / BENCH_ITERATIONS;
+
+  LOG_UNSUBSCRIBE(bench_null_subscriber);
+  LOG_SUBSCRIBE_RECORD(bench_binary_subscriber, ELOG_LEVEL_TRACE);
+  elog_bin_reset(&s_bin_state);
+  s_sink_bytes = 0;
+  start = bench_now();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    bench_span_work(i);
+  }
+  uint64_t span_binary = bench_now() - start;
+  double span_binary_bytes = (double)s_sink_bytes / BENCH_ITERATIONS;
+  LOG_UNSUBSCRIBE_RECORD(bench_binary_subscriber);
+  LOG_SUBSCRIBE(bench_null_subscriber, ELOG_LEVEL_TRACE);
+  elog_set_timestamp_source(NULL, 0);
+
+  bench_report("span: enter/exit printf lines", manual, BENCH_ITERATIONS);
+  bench_report("span: ELOG_SPAN_SCOPE text subscriber", span_text, BENCH_ITERATIONS);
+  bench_report("span: ELOG_SPAN_SCOPE binary subscriber", span_binary, BENCH_ITERATIONS);
+  printf("%-40s %6.1f / %.1f / %.1f bytes/span (%" PRIu32 " ticks/s)\n", "span: printf / span text / span binary",
+         manual_bytes, span_text_bytes, span_binary_bytes, rate);
+}
+
+/* ========================================================================== */
+/* Saturated output: one shared FIFO vs. the priority lanes of eLog_queue.c */
+/* ========================================================================== */
+
+#define BENCH_QUEUE_BYTES  2048u
+#define BENCH_QUEUE_BURSTS 2000u
+#define BENCH_LINK_BUDGET  400u /* Bytes the output takes between two bursts */
+
+static uint8_t s_queue_storage[BENCH_QUEUE_BYTES];
+static ring_t s_fifo;
+static uint32_t s_link_budget;
+static uint32_t s_fifo_sent[3];
+static const char s_band_names[3][16] = {"critical", "error/warning", "trace"};
+
+static int bench_link_output(int handle, const char *buf, size_t len)
+{
+  (void)handle;
+  (void)buf;
+  if (len > s_link_budget)
+  {
+    return -1;
+  }
+  s_link_budget -= (uint32_t)len;
+  return 0;
+}
+
+/* Baseline: every level shares one ring; stored as [band][u16 length][text] */
+static int bench_fifo_subscriber(const elog_record_t *rec)
+{
+  size_t len = 0;
+  const char *text = elog_record_text(rec, &len);
+  uint8_t frame[3u + ELOG_FULL_MESSAGE_LENGTH];
+  if (ring_get_free(&s_fifo) < len + 3u)
+  {
+    return -1;
+  }
+  frame[0] = (rec->level >= ELOG_LEVEL_CRITICAL) ? 0u : (rec->level >= ELOG_LEVEL_WARNING) ? 1u : 2u;
+  frame[1] = (uint8_t)(len & 0xFFu);
+  frame[2] = (uint8_t)(len >> 8);
+  memcpy(frame + 3, text, len);
+  ring_write_multiple(&s_fifo, frame, (uint32_t)(len + 3u));
+  return 0;
+}
+
+static void bench_fifo_drain(void)
+{
+  uint8_t frame[3u + ELOG_FULL_MESSAGE_LENGTH];
+  while (ring_peek_front_multiple(&s_fifo, frame, 3) == 3u)
+  {
+    uint32_t n = (uint32_t)frame[1] | ((uint32_t)frame[2] << 8);
+    ring_peek_front_multiple(&s_fifo, frame, n + 3u);
+    if (bench_link_output(1, (const char *)frame + 3, n) < 0)
+    {
+      return;
+    }
+    RingBuffer_PopFrontMultiple(&s_fifo, n + 3u);
+    s_fifo_sent[frame[0]]++;
+  }
+}
+
+static void bench_log_burst(uint32_t i)
+{
+  for (uint32_t k = 0; k < 20u; k++)
+  {
+    elog_message(ELOG_MD_SENSOR, ELOG_LEVEL_TRACE, "adc ch%u raw %u", k & 3u, (i + k) & 0xFFFu);
+  }
+  for (uint32_t k = 0; k < 3u; k++)
+  {
+    elog_message(ELOG_MD_HW_I2C, ELOG_LEVEL_ERROR, "i2c nack addr 0x%02X", 0x40u + k);
+  }
+  elog_message(ELOG_MD_HW_PMIC, ELOG_LEVEL_CRITICAL, "brownout vbat=%u mV", 3000u + (i & 0xFFu));
+}
+
+static void bench_priority_queue(void)
+{
+  const uint32_t logged[3] = {BENCH_QUEUE_BURSTS, 3u * BENCH_QUEUE_BURSTS, 20u * BENCH_QUEUE_BURSTS};
+  LOG_UNSUBSCRIBE(bench_null_subscriber);
+
+  ring_init(&s_fifo, s_queue_storage, sizeof(s_queue_storage), 1);
+  LOG_SUBSCRIBE_RECORD(bench_fifo_subscriber, ELOG_LEVEL_TRACE);
+  for (uint32_t i = 0; i < BENCH_QUEUE_BURSTS; i++)
+  {
+    bench_log_burst(i);
+    s_link_budget = BENCH_LINK_BUDGET;
+    bench_fifo_drain();
+  }
+  elog_unsubscribe_record(bench_fifo_subscriber);
+
+  const uint32_t lanes[ELOG_QUEUE_LANES] = {256u, 512u, BENCH_QUEUE_BYTES - 768u};
+  elog_queue_init(s_queue_storage, lanes);
+  LOG_SUBSCRIBE_RECORD(elog_queue_subscriber, ELOG_LEVEL_TRACE);
+  uint64_t start = bench_now();
+  for (uint32_t i = 0; i < BENCH_QUEUE_BURSTS; i++)
+  {
+    bench_log_burst(i);
+    s_link_budget = BENCH_LINK_BUDGET;
+    elog_queue_drain(bench_link_output, 0);
+  }
+  uint64_t ticks = bench_now() - start;
+  elog_unsubscribe_record(elog_queue_subscriber);
+
+  elog_queue_stats_t stats;
+  elog_queue_get_stats(&stats);
+  for (uint32_t b = 0; b < 3u; b++)
+  {
+    printf("saturated link: %-24s %5.1f%% shared FIFO %5.1f%% lanes\n", s_band_names[b],
+           100.0 * s_fifo_sent[b] / logged[b], 100.0 * stats.delivered[b] / logged[b]);
+  }
+  bench_report("saturated link: queue + drain per record", ticks, 24u * BENCH_QUEUE_BURSTS);
+  LOG_SUBSCRIBE(bench_null_subscriber, ELOG_LEVEL_TRACE);
+}
+
+/* ========================================================================== */
+/* Slow subscriber: backpressure policies, caller cost vs. lines delivered */
+/* ========================================================================== */
+
+#define BENCH_BP_LINES 20000u
+
+static uint8_t s_bp_backlog[1024];
+static uint32_t s_bp_spilled_bytes;
+
+/* The link frees BENCH_LINK_BUDGET bytes every 8 lines, or on every millisecond waited */
+static void bench_bp_wait(uint32_t ms)
+{
+  s_link_budget += ms * BENCH_LINK_BUDGET;
+}
+
+static int bench_bp_spill(int handle, const char *buf, size_t len)
+{
+  (void)handle;
+  (void)buf;
+  s_bp_spilled_bytes += (uint32_t)len;
+  return 0;
+}
+
+static void bench_backpressure(void)
+{
+  static elog_backpressure_t bp;
+  static const char *const names[] = {"backpressure: drop newest", "backpressure: drop oldest",
+                                      "backpressure: block 2 ms", "backpressure: spill"};
+  const elog_bp_config_t configs[] = {
+      {.policy = ELOG_BP_DROP_NEWEST},
+      {.policy = ELOG_BP_DROP_OLDEST, .backlog = s_bp_backlog, .backlog_size = sizeof(s_bp_backlog)},
+      {.policy = ELOG_BP_BLOCK, .timeout_ms = 2, .wait_ms = bench_bp_wait},
+      {.policy = ELOG_BP_SPILL, .spill = bench_bp_spill},
+  };
+
+  LOG_UNSUBSCRIBE(bench_null_subscriber);
+  LOG_SUBSCRIBE(bench_link_output, ELOG_LEVEL_TRACE);
+  for (uint32_t p = 0; p < sizeof(configs) / sizeof(configs[0]); p++)
+  {
+    elog_set_backpressure(bench_link_output, &bp, &configs[p]);
+    s_link_budget = 0;
+    uint64_t start = bench_now();
+    for (uint32_t i = 0; i < BENCH_BP_LINES; i++)
+    {
+      if ((i & 7u) == 0u) { s_link_budget = BENCH_LINK_BUDGET; }
+      elog_message(ELOG_MD_HW_I2C, ELOG_LEVEL_ERROR, "i2c nack addr 0x%02X retry %u", 0x40u + (i & 3u), i);
+    }
+    uint64_t ticks = bench_now() - start;
+
+    elog_bp_stats_t stats;
+    elog_get_backpressure_stats(&bp, &stats);
+    printf("%-40s %10.1f ticks/call %5.1f%% delivered %5.1f%% spilled\n", names[p], (double)ticks / BENCH_BP_LINES,
+           100.0 * stats.delivered / BENCH_BP_LINES, 100.0 * stats.spilled / BENCH_BP_LINES);
+  }
+  elog_set_backpressure(bench_link_output, NULL, NULL);
+  LOG_UNSUBSCRIBE(bench_link_output);
+  LOG_SUBSCRIBE(bench_null_subscriber, ELOG_LEVEL_TRACE);
+}
+
+#if defined(BENCH_HAVE_FILES)
+/* ========================================================================== */
+/* File output: fwrite+fflush per line vs. buffered writer thread */
+/* ========================================================================== */
+
+#define BENCH_FILE_PATH "elog_bench.log"
+
+static FILE *s_naive_file;
+
+static int bench_naive_file_subscriber(int handle, const char *buf, size_t len)
+{
+  (void)handle;
+  fwrite(buf, 1, len, s_naive_file);
+  fflush(s_naive_file);
+  return 0;
+}
+
+static double bench_wall_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void bench_file_report(const char *name, uint64_t bytes, double seconds)
+{
+  printf("%-40s %10.1f MB/s\n", name, (double)bytes / seconds / 1e6);
+}
+
+static void bench_file_throughput(void)
+{
+  LOG_UNSUBSCRIBE(bench_null_subscriber);
+
+  s_naive_file = fopen(BENCH_FILE_PATH, "w");
+  LOG_SUBSCRIBE(bench_naive_file_subscriber, ELOG_LEVEL_TRACE);
+  double start = bench_wall_seconds();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    ELOG_ERROR(ELOG_MD_SENSOR, "sensor %u read failed: status=0x%02X", i, 0x5Au);
+  }
+  double naive = bench_wall_seconds() - start;
+  long naive_bytes = ftell(s_naive_file);
+  LOG_UNSUBSCRIBE(bench_naive_file_subscriber);
+  fclose(s_naive_file);
+
+  elog_file_config_t cfg = {.path = BENCH_FILE_PATH, .max_bytes = 8u * 1024u * 1024u, .max_files = 2};
+  elog_file_open(&cfg);
+  LOG_SUBSCRIBE(elog_file_subscriber, ELOG_LEVEL_TRACE);
+  start = bench_wall_seconds();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    ELOG_ERROR(ELOG_MD_SENSOR, "sensor %u read failed: status=0x%02X", i, 0x5Au);
+  }
+  elog_file_flush();
+  double buffered = bench_wall_seconds() - start;
+  LOG_UNSUBSCRIBE(elog_file_subscriber);
+  elog_file_stats_t stats;
+  elog_file_get_stats(&stats);
+  elog_file_close();
+
+  elog_mmap_open(BENCH_FILE_PATH, 64u * 1024u * 1024u, 0);
+  LOG_SUBSCRIBE(elog_mmap_subscriber, ELOG_LEVEL_TRACE);
+  start = bench_wall_seconds();
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    ELOG_ERROR(ELOG_MD_SENSOR, "sensor %u read failed: status=0x%02X", i, 0x5Au);
+  }
+  double mapped = bench_wall_seconds() - start;
+  LOG_UNSUBSCRIBE(elog_mmap_subscriber);
+  size_t mapped_bytes = elog_mmap_size();
+  elog_mmap_close();
+
+  bench_file_report("file: fwrite+fflush per line", (uint64_t)naive_bytes, naive);
+  bench_file_report("file: buffered writer thread", stats.bytes_written, buffered);
+  bench_file_report("file: mmap sink", (uint64_t)mapped_bytes, mapped);
+  printf("%-40s %10" PRIu32 " dropped, %" PRIu32 " rotations\n", "file: buffered writer", stats.dropped,
+         stats.rotations);
+
+  unlink(BENCH_FILE_PATH);
+  unlink(BENCH_FILE_PATH ".1");
+  LOG_SUBSCRIBE(bench_null_subscriber, ELOG_LEVEL_TRACE);
+}
+#endif
+
+/* ========================================================================== */
+/* Main */
+/* ========================================================================== */
+
+int main(void)
+{
+  LOG_INIT();
+  LOG_SUBSCRIBE(bench_null_subscriber, ELOG_LEVEL_TRACE);
+
+  printf("eLog benchmark (%u iterations)\n", BENCH_ITERATIONS);
+  bench_format_single_pass();
+  uint32_t fmt_mismatches = bench_formatter_check();
+  bench_formatter();
+  bench_disabled_statement();
+  bench_level_control();
+  bench_unwanted_record();
+  bench_binary_frames();
+  bench_storm();
+  bench_repeated();
+  bench_sampling();
+  bench_isr();
+  bench_hexdump();
+  bench_kv();
+  bench_span();
+  bench_priority_queue();
+  bench_backpressure();
+#if defined(BENCH_HAVE_FILES)
+  bench_file_throughput();
+#endif
+  return (fmt_mismatches == 0u) ? 0 : 1;
+}
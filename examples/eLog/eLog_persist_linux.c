@@ -0,0 +1,90 @@
+/***********************************************************
+ * @file	eLog_persist_linux.c
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Crash-persistent log ring on Linux, backed by a file mmap
+ *
+ *         Build and run on the host (from the repository root):
+ *           gcc -O2 -I. -IeLog -Iring examples/eLog/eLog_persist_linux.c \
+ *               eLog/eLog.c eLog/eLog_fmt.c eLog/eLog_bin.c eLog/eLog_persist.c ring/ring.c common.c -o elog_persist
+ *           ./elog_persist crash     # logs, then aborts (the "hard fault")
+ *           ./elog_persist           # recovers and prints the frames of the crashed run
+ *
+ *         On target the region is a static buffer in no-init RAM:
+ *           static uint8_t s_crash_log[4096] ELOG_PERSIST_NOINIT;
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+
+#include "eLog.h"
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define PERSIST_FILE "elog_persist.bin"
+#define PERSIST_SIZE 4096u
+
+/* Console subscriber backend */
+int LPUartQueueBuffWrite(int handle, const char *buf, size_t bufSize)
+{
+  (void)handle;
+  return (int)fwrite(buf, 1, bufSize, stdout);
+}
+
+static void print_frame(const elog_bin_frame_t *frame, void *ctx)
+{
+  (void)ctx;
+  printf("  [%" PRIu32 "] %s:%u,%" PRIu32 "@%" PRIu32 ": %.*s\n", frame->global_sequence, elog_level_name(frame->level),
+         (unsigned)frame->module, frame->sequence, frame->timestamp, (int)frame->payload_len,
+         (const char *)frame->payload);
+}
+
+int main(int argc, char **argv)
+{
+  /* A MAP_SHARED file mapping outlives the process, like no-init RAM outlives a reset */
+  int fd = open(PERSIST_FILE, O_RDWR | O_CREAT, 0644);
+  if (fd < 0 || ftruncate(fd, PERSIST_SIZE) != 0)
+  {
+    perror(PERSIST_FILE);
+    return 1;
+  }
+  void *region = mmap(NULL, PERSIST_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (region == MAP_FAILED)
+  {
+    perror("mmap");
+    return 1;
+  }
+
+  LOG_INIT();
+  elog_timestamp_use_monotonic_clock();
+  elog_persist_init(region, PERSIST_SIZE);
+
+  if (elog_persist_pending() != 0u)
+  {
+    printf("Recovered log of the previous run:\n");
+    uint32_t frames = elog_persist_recover(print_frame, NULL);
+    printf("%" PRIu32 " frames\n", frames);
+  }
+
+  LOG_SUBSCRIBE(elog_console_subscriber, ELOG_LEVEL_DEBUG);
+  elog_subscribe_record(elog_persist_subscriber, ELOG_LEVEL_DEBUG, ELOG_MODULE_MASK_ALL);
+
+  for (int i = 0; i < 200; i++)
+  {
+    ELOG_WARNING(ELOG_MD_SENSOR, "sample %d out of range", i);
+  }
+  ELOG_CRITICAL(ELOG_MD_DEFAULT, "fault: error 0x%02X", (unsigned)ELOG_CRITICAL_ERR_HARDFAULT);
+
+  if (argc > 1 && strcmp(argv[1], "crash") == 0)
+  {
+    abort(); /* Stand-in for a hard fault: no shutdown, no flush */
+  }
+  return 0;
+}
@@ -0,0 +1,197 @@
+/***********************************************************
+ * @file	eLog_trace_export.c
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Export eLog span frames as Chrome trace JSON (chrome://tracing, ui.perfetto.dev)
+ *
+ *         Build and run on the host (from the repository root):
+ *           gcc -O2 -I. -IeLog -Iring examples/eLog/eLog_trace_export.c \
+ *               eLog/eLog.c eLog/eLog_fmt.c eLog/eLog_bin.c eLog/eLog_trace.c ring/ring.c common.c -o elog_trace
+ *           ./elog_trace                          # runs traced demo code, writes elog_frames.bin + trace.json
+ *           ./elog_trace capture.bin 64000000     # converts a captured frame stream (target tick rate)
+ *
+ *         On target a record subscriber sends the frames of elog_bin_encode_record()
+ *         over UART/RTT; the capture of that byte stream is the input of the second form.
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+
+#include "eLog.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FRAMES_FILE "elog_frames.bin"
+#define TRACE_FILE  "trace.json"
+
+static FILE *s_frames;
+static elog_bin_state_t s_encoder;
+
+/* Console subscriber backend */
+int LPUartQueueBuffWrite(int handle, const char *buf, size_t bufSize)
+{
+  (void)handle;
+  return (int)fwrite(buf, 1, bufSize, stdout);
+}
+
+/* Binary sink standing in for the target's UART/RTT link */
+static int frame_subscriber(const elog_record_t *rec)
+{
+  uint8_t frame[ELOG_BIN_HEADER_MAX + ELOG_FULL_MESSAGE_LENGTH];
+  size_t len = elog_bin_encode_record(&s_encoder, rec, frame, sizeof(frame));
+  return (len != 0u && fwrite(frame, 1, len, s_frames) == len) ? 0 : -1;
+}
+
+/* ========================================================================== */
+/* Traced Demo Code */
+/* ========================================================================== */
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void busy_wait_us(uint32_t us)
+{
+  uint64_t until = now_ns() + (uint64_t)us * 1000u;
+  while (now_ns() < until)
+  {
+  }
+}
+
+static int sensor_read(int channel)
+{
+  ELOG_SPAN_SCOPE(ELOG_MD_SENSOR, "sensor_read");
+  busy_wait_us(200u);
+  if (channel == 3)
+  {
+    ELOG_ERROR(ELOG_MD_SENSOR, "channel %d timeout", channel);
+    return -1; /* The span still ends here */
+  }
+  busy_wait_us(100u);
+  return channel * 10;
+}
+
+static void flash_commit(void)
+{
+  ELOG_SPAN_BEGIN(erase, ELOG_MD_FLASH, "flash_erase");
+  busy_wait_us(1500u);
+  ELOG_SPAN_END(erase);
+
+  ELOG_SPAN_BEGIN(program, ELOG_MD_FLASH, "flash_program");
+  busy_wait_us(800u);
+  ELOG_SPAN_END(program);
+}
+
+static void run_demo(void)
+{
+  LOG_INIT();
+  elog_timestamp_use_monotonic_clock();
+  LOG_SUBSCRIBE(elog_console_subscriber, ELOG_LEVEL_TRACE);
+  elog_subscribe_record(frame_subscriber, ELOG_LEVEL_TRACE, ELOG_MODULE_MASK_ALL);
+
+  for (int cycle = 0; cycle < 3; cycle++)
+  {
+    ELOG_SPAN_SCOPE(ELOG_MD_DEFAULT, "measurement_cycle");
+    for (int channel = 0; channel < 4; channel++)
+    {
+      (void)sensor_read(channel);
+    }
+    flash_commit();
+  }
+  elog_unsubscribe_record(frame_subscriber);
+}
+
+/* ========================================================================== */
+/* Conversion */
+/* ========================================================================== */
+
+static int convert(const char *in_path, uint32_t ts_rate)
+{
+  FILE *in = fopen(in_path, "rb");
+  if (in == NULL)
+  {
+    perror(in_path);
+    return 1;
+  }
+  static uint8_t buf[1u << 20];
+  size_t len = fread(buf, 1, sizeof(buf), in);
+  fclose(in);
+
+  FILE *out = fopen(TRACE_FILE, "w");
+  if (out == NULL)
+  {
+    perror(TRACE_FILE);
+    return 1;
+  }
+
+  char event[ELOG_FULL_MESSAGE_LENGTH * 2u + 128u];
+  fputs("[\n", out);
+  elog_bin_state_t decoder;
+  elog_trace_json_t tj;
+  elog_bin_reset(&decoder);
+  elog_trace_json_init(&tj, ts_rate);
+  bool seen[ELOG_MD_MAX] = {false};
+  uint32_t frames = 0;
+  uint32_t events = 0;
+  size_t pos = 0;
+  while (pos < len)
+  {
+    elog_bin_frame_t frame;
+    int used = elog_bin_decode(&decoder, buf + pos, len - pos, &frame);
+    if (used <= 0)
+    {
+      pos++; /* Skip a corrupt or truncated byte and resynchronize */
+      continue;
+    }
+    pos += (size_t)used;
+    frames++;
+    if (elog_trace_json_event(&tj, &frame, event, sizeof(event)) > 0)
+    {
+      fprintf(out, "%s%s", (events == 0u) ? "" : ",\n", event);
+      events++;
+      if ((unsigned)frame.module < (unsigned)ELOG_MD_MAX) { seen[frame.module] = true; }
+    }
+  }
+
+  /* One metadata event per module names its track */
+  for (uint32_t module = 0; module < (uint32_t)ELOG_MD_MAX; module++)
+  {
+    if (seen[module] && elog_trace_json_module((elog_module_t)module, event, sizeof(event)) > 0)
+    {
+      fprintf(out, "%s%s", (events == 0u) ? "" : ",\n", event);
+      events++;
+    }
+  }
+  fputs("\n]\n", out);
+  fclose(out);
+
+  printf("%" PRIu32 " frames, %" PRIu32 " trace events -> %s (open in ui.perfetto.dev)\n", frames, events,
+         TRACE_FILE);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 2)
+  {
+    return convert(argv[1], (uint32_t)strtoul(argv[2], NULL, 0));
+  }
+
+  s_frames = fopen(FRAMES_FILE, "wb");
+  if (s_frames == NULL)
+  {
+    perror(FRAMES_FILE);
+    return 1;
+  }
+  elog_bin_reset(&s_encoder);
+  run_demo();
+  fclose(s_frames);
+  return convert(FRAMES_FILE, elog_get_timestamp_rate());
+}
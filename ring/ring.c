@@ -19,7 +19,10 @@
 /***********************************************************
  * @brief  Platform specific critical section macros for GCC ARM Cortex-M
  *         Uses PRIMASK to disable/enable interrupts
+ *         Host builds (Linux tests/tools) have no interrupts: the
+ *         fallback section is a no-op and only the mutex path applies.
 ************************************************************/
+#if defined(__arm__)
 __attribute__((always_inline)) static inline uint32_t __get_PRIMASK(void)
 {
   uint32_t result;
@@ -49,6 +52,12 @@ __attribute__((always_inline)) static inline uint32_t __is_isr_context(void)
   __asm volatile ("MRS %0, xpsr" : "=r" (xpsr) );
   return (xpsr & 0xFF);  // ISR is in bits [8:0] (up to 256 interrupts)
 }
+#else
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline uint32_t __read_PRIMASK_safe(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t priMask) { (void)priMask; }
+static inline uint32_t __is_isr_context(void) { return 0; }
+#endif
 
 /***********************************************************/
 
@@ -467,6 +476,53 @@ uint32_t RingBuffer_PopFrontMultiple(ring_t *rb, uint32_t count) {
   return elements_to_remove;
 }
 
+// Contiguous readable span at the tail (zero-copy consumers, e.g. DMA)
+uint32_t ring_peek_contiguous(const ring_t *rb, void **data) {
+  if (rb == NULL || data == NULL) { return 0; }
+  uint32_t count = *(volatile const uint32_t *)&rb->count;
+  if (count == 0) {
+    *data = NULL;
+    return 0;
+  }
+  uint32_t tail = rb->tail;
+  uint32_t to_end = rb->size - tail;
+  *data = (uint8_t *)rb->buffer + (tail * rb->element_size);
+  return (count < to_end) ? count : to_end;
+}
+
+// Release elements handed out by ring_peek_contiguous (caller provides locking)
+uint32_t ring_consume(ring_t *rb, uint32_t count) {
+  if (rb == NULL) { return 0; }
+  if (count > rb->count) { count = rb->count; }
+  rb->tail = (rb->tail + count) % rb->size;
+  rb->count -= count;
+  return count;
+}
+
+// Contiguous free span at the head (zero-copy producers)
+uint32_t ring_reserve_contiguous(const ring_t *rb, void **data) {
+  if (rb == NULL || data == NULL) { return 0; }
+  uint32_t free_space = rb->size - *(volatile const uint32_t *)&rb->count;
+  if (free_space == 0) {
+    *data = NULL;
+    return 0;
+  }
+  uint32_t head = rb->head;
+  uint32_t to_end = rb->size - head;
+  *data = (uint8_t *)rb->buffer + (head * rb->element_size);
+  return (free_space < to_end) ? free_space : to_end;
+}
+
+// Publish elements filled in through ring_reserve_contiguous (caller provides locking)
+uint32_t ring_commit(ring_t *rb, uint32_t count) {
+  if (rb == NULL) { return 0; }
+  uint32_t free_space = rb->size - rb->count;
+  if (count > free_space) { count = free_space; }
+  rb->head = (rb->head + count) % rb->size;
+  rb->count += count;
+  return count;
+}
+
 // Peek the oldest element from the ring buffer (does not move tail)
 bool ring_peek_front(const ring_t *rb, void *data) {
   if (rb == NULL || ring_is_empty(rb)) { return false; }
@@ -211,6 +211,84 @@ bool ring_pop_back(ring_t *rb);
  */
 uint32_t ring_pop_back_multiple(ring_t *rb, uint32_t count);
 
+/**
+ * @brief Pops the oldest element from the front of the ring buffer.
+ *
+ * @param rb Pointer to the ring buffer structure. Must be initialized before use.
+ * 
+ * @return true if an element was removed.
+ * @return false if the ring buffer is empty.
+ */
+bool RingBuffer_PopFront(ring_t *rb);
+
+/**
+ * @brief Pops multiple elements from the front of the ring buffer (oldest first).
+ *
+ * @param rb Pointer to the ring buffer structure. Must be initialized before use.
+ * @param count The number of elements to pop from the front of the ring buffer.
+ * 
+ * @return The number of elements actually popped from the front of the ring buffer.
+ */
+uint32_t RingBuffer_PopFrontMultiple(ring_t *rb, uint32_t count);
+
+/**
+ * @brief Gets the contiguous run of readable elements starting at the tail.
+ *
+ * This function exposes the oldest data in place so a consumer (typically a DMA
+ * engine) can read it without copying. When the stored data wraps around the end of
+ * the buffer only the part up to the end is returned; the remainder becomes visible
+ * after ring_consume() moves the tail back to index 0.
+ *
+ * @param rb Pointer to the ring buffer structure. Must be initialized before use.
+ * @param data Receives a pointer to the first readable element (NULL when empty).
+ * 
+ * @return The number of contiguous readable elements (0 if the ring buffer is empty).
+ *
+ * @note No lock is taken; the span stays valid until it is consumed because writers
+ *       never overwrite elements that are still counted as stored.
+ */
+uint32_t ring_peek_contiguous(const ring_t *rb, void **data);
+
+/**
+ * @brief Releases elements previously obtained with ring_peek_contiguous().
+ *
+ * @param rb Pointer to the ring buffer structure. Must be initialized before use.
+ * @param count The number of elements to release from the tail.
+ * 
+ * @return The number of elements actually released.
+ *
+ * @note No lock is taken. Only the tail is moved by the consumer, but the element count
+ *       is shared with the producer, so callers racing a producer must wrap the call in
+ *       a short critical section (see ring_tx.c).
+ */
+uint32_t ring_consume(ring_t *rb, uint32_t count);
+
+/**
+ * @brief Gets the contiguous run of free elements starting at the head.
+ *
+ * A producer fills the returned area in place and publishes it with ring_commit().
+ * When the free space wraps around the end of the buffer only the part up to the end
+ * is returned.
+ *
+ * @param rb Pointer to the ring buffer structure. Must be initialized before use.
+ * @param data Receives a pointer to the first free element (NULL when full).
+ * 
+ * @return The number of contiguous free elements (0 if the ring buffer is full).
+ */
+uint32_t ring_reserve_contiguous(const ring_t *rb, void **data);
+
+/**
+ * @brief Publishes elements written into an area returned by ring_reserve_contiguous().
+ *
+ * @param rb Pointer to the ring buffer structure. Must be initialized before use.
+ * @param count The number of elements to publish at the head.
+ * 
+ * @return The number of elements actually published.
+ *
+ * @note No lock is taken; the same rules as for ring_consume() apply.
+ */
+uint32_t ring_commit(ring_t *rb, uint32_t count);
+
 /**
  * @brief Pushes an element to the front of the ring buffer (overwrites oldest if full).
  *
@@ -0,0 +1,326 @@
+/***********************************************************
+ * @file	ring_tx.c
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Ring buffer backed DMA transmitter
+ *         Producers copy into the ring with interrupts enabled (a mutex
+ *         serializes tasks) and only publish the new head with interrupts
+ *         masked. The engine state (IDLE/BUSY) is claimed in the same short
+ *         masked section that picks the next contiguous span, so a write
+ *         racing the TX-complete interrupt can never strand queued data.
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+#include "ring_tx.h"
+#include <string.h>
+#include "mutex_common.h"
+
+/***********************************************************
+ * @brief  Interrupt masking for GCC ARM Cortex-M (PRIMASK).
+ *         Host builds have no interrupts: a global spin lock stands in
+ *         for the mask so a simulated DMA thread calling
+ *         ring_tx_on_tx_complete() behaves like an ISR.
+************************************************************/
+#if defined(__arm__)
+__attribute__((always_inline)) static inline uint32_t ring_tx_irq_save(void)
+{
+  uint32_t primask;
+  __asm volatile("mrs %0, primask\n cpsid i" : "=r"(primask) : : "memory");
+  return primask;
+}
+
+__attribute__((always_inline)) static inline void ring_tx_irq_restore(uint32_t primask)
+{
+  __asm volatile("msr primask, %0" : : "r"(primask) : "memory");
+}
+
+__attribute__((always_inline)) static inline uint32_t ring_tx_in_isr(void)
+{
+  uint32_t ipsr;
+  __asm volatile("mrs %0, ipsr" : "=r"(ipsr));
+  return ipsr & 0x1FFu;
+}
+#else
+static volatile uint8_t s_irq_lock;
+
+static inline uint32_t ring_tx_irq_save(void)
+{
+  while (__atomic_test_and_set(&s_irq_lock, __ATOMIC_ACQUIRE))
+  {
+  }
+  return 0;
+}
+
+static inline void ring_tx_irq_restore(uint32_t primask)
+{
+  (void)primask;
+  __atomic_clear(&s_irq_lock, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t ring_tx_in_isr(void) { return 0; }
+#endif
+
+/* ========================================================================== */
+/* Measured Critical Sections */
+/* ========================================================================== */
+
+static inline uint32_t ring_tx_cs_enter(ring_tx_t *tx, uint32_t *t0)
+{
+  uint32_t primask = ring_tx_irq_save();
+  *t0 = (tx->ticks != NULL) ? tx->ticks() : 0u;
+  return primask;
+}
+
+static inline void ring_tx_cs_exit(ring_tx_t *tx, uint32_t primask, uint32_t t0)
+{
+  if (tx->ticks != NULL)
+  {
+    uint32_t elapsed = tx->ticks() - t0;
+    if (elapsed > tx->stats.irq_off_max)
+    {
+      tx->stats.irq_off_max = elapsed;
+    }
+    tx->stats.irq_off_total += elapsed;
+    tx->stats.irq_off_count++;
+  }
+  ring_tx_irq_restore(primask);
+}
+
+/* ========================================================================== */
+/* Engine */
+/* ========================================================================== */
+
+/**
+ * @brief Release a finished span, then claim the engine and start the next span.
+ * @param tx: Transmitter
+ * @param done: Bytes completed by the driver (0 when called from a producer)
+ * @param owner: true if the caller already owns the engine (completion path)
+ * @note The emptiness check and the BUSY->IDLE transition share one masked section,
+ *       and producers publish under the same mask before kicking, so either the
+ *       engine sees the new data or the producer sees the engine IDLE.
+ */
+static void ring_tx_advance(ring_tx_t *tx, uint32_t done, bool owner)
+{
+  void *span = NULL;
+  uint32_t len;
+  uint32_t t0;
+  uint32_t primask = ring_tx_cs_enter(tx, &t0);
+
+  if (!owner && tx->active != 0u)
+  {
+    ring_tx_cs_exit(tx, primask, t0);
+    return;
+  }
+  if (done != 0u)
+  {
+    ring_consume(&tx->ring, done);
+    tx->stats.bytes_sent += done;
+    tx->inflight = 0u;
+  }
+
+  len = ring_peek_contiguous(&tx->ring, &span);
+  if (len == 0u)
+  {
+    tx->active = 0u;
+    ring_tx_cs_exit(tx, primask, t0);
+    return;
+  }
+  if (len > RING_TX_MAX_SPAN)
+  {
+    len = RING_TX_MAX_SPAN;
+  }
+  tx->active = 1u;
+  tx->inflight = len;
+  tx->stats.spans++;
+  ring_tx_cs_exit(tx, primask, t0);
+
+  /* The driver is started with interrupts enabled */
+  if (tx->start_tx(tx->ctx, (const uint8_t *)span, len))
+  {
+    return;
+  }
+
+  primask = ring_tx_cs_enter(tx, &t0);
+  tx->inflight = 0u;
+  tx->active = 0u;
+  tx->stats.start_failures++;
+  ring_tx_cs_exit(tx, primask, t0);
+}
+
+/* ========================================================================== */
+/* Public API */
+/* ========================================================================== */
+
+void ring_tx_init(ring_tx_t *tx, uint8_t *buffer, uint32_t size, ring_tx_start_fn start_tx, void *ctx)
+{
+  if (tx == NULL)
+  {
+    return;
+  }
+  memset(tx, 0, sizeof(*tx));
+  ring_init(&tx->ring, buffer, size, 1);
+  tx->start_tx = start_tx;
+  tx->ctx = ctx;
+  /* Producer mutex is created lazily in ring_tx_write() once the RTOS runs */
+}
+
+void ring_tx_deinit(ring_tx_t *tx)
+{
+  if (tx == NULL)
+  {
+    return;
+  }
+  if (tx->mutex != NULL)
+  {
+    utilities_mutex_delete(tx->mutex);
+    tx->mutex = NULL;
+  }
+  /* ring_init() never creates the ring's own mutex; nothing else to free */
+}
+
+void ring_tx_set_tick_source(ring_tx_t *tx, ring_tx_ticks_fn ticks)
+{
+  if (tx != NULL)
+  {
+    tx->ticks = ticks;
+  }
+}
+
+uint32_t ring_tx_write(ring_tx_t *tx, const void *data, uint32_t len)
+{
+  const uint8_t *src = (const uint8_t *)data;
+  uint32_t left = len;
+  bool locked = false;
+  bool room;
+  uint32_t primask;
+  uint32_t t0;
+
+  if (tx == NULL || data == NULL || len == 0u || tx->start_tx == NULL)
+  {
+    return 0;
+  }
+
+  /* Tasks serialize on a mutex and copy with interrupts enabled; ISRs, bare metal and
+   * a failed take fall back to masking interrupts for the whole write */
+  if (!ring_tx_in_isr() && utilities_is_RTOS_ready())
+  {
+    if (tx->mutex == NULL)
+    {
+      tx->mutex = utilities_mutex_create();
+    }
+    if (tx->mutex != NULL && utilities_mutex_take(tx->mutex, MUTEX_TIMEOUT_MS) == MUTEX_OK)
+    {
+      locked = true;
+    }
+  }
+
+  /* Free space only grows behind our back (the engine consumes), so the check holds.
+   * A masked writer that interrupted a task mid-copy must not reuse the same head. */
+  primask = ring_tx_cs_enter(tx, &t0);
+  room = (tx->ring.size - tx->ring.count >= len) && (tx->writing == 0u);
+  if (!room)
+  {
+    tx->stats.dropped += len;
+    ring_tx_cs_exit(tx, primask, t0);
+    if (locked)
+    {
+      utilities_mutex_give(tx->mutex);
+    }
+    return 0;
+  }
+  if (locked)
+  {
+    tx->writing = 1u;
+    ring_tx_cs_exit(tx, primask, t0);
+  }
+
+  /* At most two spans: up to the end of the buffer, then from index 0 */
+  while (left > 0u)
+  {
+    void *dst;
+    uint32_t n = ring_reserve_contiguous(&tx->ring, &dst);
+    if (n > left)
+    {
+      n = left;
+    }
+    memcpy(dst, src, n);
+    if (locked)
+    {
+      primask = ring_tx_cs_enter(tx, &t0);
+    }
+    ring_commit(&tx->ring, n);
+    tx->stats.bytes_queued += n;
+    src += n;
+    left -= n;
+    if (locked)
+    {
+      if (left == 0u)
+      {
+        tx->writing = 0u;
+      }
+      ring_tx_cs_exit(tx, primask, t0);
+    }
+  }
+
+  if (locked)
+  {
+    utilities_mutex_give(tx->mutex);
+  }
+  else
+  {
+    ring_tx_cs_exit(tx, primask, t0);
+  }
+
+  ring_tx_advance(tx, 0u, false);
+  return len;
+}
+
+void ring_tx_kick(ring_tx_t *tx)
+{
+  if (tx == NULL || tx->start_tx == NULL)
+  {
+    return;
+  }
+  ring_tx_advance(tx, 0u, false);
+}
+
+void ring_tx_on_tx_complete(ring_tx_t *tx)
+{
+  if (tx == NULL)
+  {
+    return;
+  }
+  ring_tx_advance(tx, tx->inflight, true);
+}
+
+uint32_t ring_tx_pending(const ring_tx_t *tx)
+{
+  if (tx == NULL)
+  {
+    return 0;
+  }
+  return *(volatile const uint32_t *)&tx->ring.count;
+}
+
+bool ring_tx_is_idle(const ring_tx_t *tx)
+{
+  if (tx == NULL)
+  {
+    return true;
+  }
+  return tx->active == 0u;
+}
+
+void ring_tx_get_stats(const ring_tx_t *tx, ring_tx_stats_t *stats)
+{
+  if (tx == NULL || stats == NULL)
+  {
+    return;
+  }
+  uint32_t t0;
+  uint32_t primask = ring_tx_cs_enter((ring_tx_t *)tx, &t0);
+  *stats = tx->stats;
+  ring_tx_irq_restore(primask);
+}
@@ -0,0 +1,137 @@
+/***********************************************************
+ * @file	ring_tx.h
+ * @author	Andy Chen (clgm216@gmail.com)
+ * @version	0.01
+ * @date	2025-12-28
+ * @brief  Ring buffer backed transmitter for DMA driven peripherals
+ *         (UART/SPI/USB CDC). Producers queue bytes from any context;
+ *         the engine hands contiguous spans of the ring straight to the
+ *         driver and chains the next span from the TX-complete interrupt.
+ * **********************************************************
+ * @copyright Copyright (c) 2025 TTK. All rights reserved.
+ *
+ ************************************************************/
+#ifndef RING_TX_H_
+#define RING_TX_H_
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "ring.h"
+
+/* Largest span handed to the driver in one go (e.g. the 16-bit DMA NDTR limit) */
+#ifndef RING_TX_MAX_SPAN
+#define RING_TX_MAX_SPAN 0xFFFFu
+#endif
+
+/**
+ * @brief Driver hook: start transmitting @p len bytes at @p data.
+ * @param ctx: Driver context given to ring_tx_init()
+ * @param data: First byte of the span, points into the ring storage (no copy)
+ * @param len: Span length in bytes
+ * @return true if the transfer was started; ring_tx_on_tx_complete() must then be called
+ *         exactly once when it finishes (normally from the DMA TX-complete interrupt).
+ *         false leaves the data queued; the next ring_tx_write() or ring_tx_kick() retries.
+ * @note Must not call ring_tx_on_tx_complete() itself; the completion interrupt may fire
+ *       before start_tx returns, which is fine.
+ */
+typedef bool (*ring_tx_start_fn)(void *ctx, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Optional free-running tick counter used to measure interrupt-off time.
+ */
+typedef uint32_t (*ring_tx_ticks_fn)(void);
+
+/* Transmitter counters */
+typedef struct {
+  uint32_t bytes_queued;   /* Bytes accepted by ring_tx_write() */
+  uint32_t bytes_sent;     /* Bytes reported complete by the driver */
+  uint32_t dropped;        /* Bytes rejected because the ring was full */
+  uint32_t spans;          /* Transfers started */
+  uint32_t start_failures; /* start_tx returned false */
+  uint32_t irq_off_max;    /* Longest interrupt-off section in ticks (needs a tick source) */
+  uint32_t irq_off_total;  /* Sum of interrupt-off sections in ticks */
+  uint32_t irq_off_count;  /* Number of interrupt-off sections measured */
+} ring_tx_stats_t;
+
+typedef struct ring_tx {
+  ring_t ring;                 /* Byte ring holding queued data, including the span in flight */
+  ring_tx_start_fn start_tx;   /* Driver hook */
+  void *ctx;                   /* Driver context */
+  ring_tx_ticks_fn ticks;      /* Optional tick source for interrupt-off measurement */
+  void *mutex;                 /* Producer lock (created lazily once the RTOS is running) */
+  volatile uint32_t active;    /* 1 while the engine is owned (span in flight or being started) */
+  volatile uint32_t inflight;  /* Length of the span handed to start_tx */
+  volatile uint32_t writing;   /* 1 while a task copies into the ring with interrupts enabled */
+  ring_tx_stats_t stats;
+} ring_tx_t;
+
+/**
+ * @brief Initialize a transmitter on a caller-provided byte buffer.
+ * @param tx: Transmitter to initialize
+ * @param buffer: Storage for queued bytes, must outlive the transmitter and be DMA reachable
+ * @param size: Buffer size in bytes
+ * @param start_tx: Driver hook starting a transfer
+ * @param ctx: Driver context passed to start_tx
+ */
+void ring_tx_init(ring_tx_t *tx, uint8_t *buffer, uint32_t size, ring_tx_start_fn start_tx, void *ctx);
+
+/**
+ * @brief Release the producer mutex. The buffer is owned by the caller.
+ * @param tx: Transmitter
+ */
+void ring_tx_deinit(ring_tx_t *tx);
+
+/**
+ * @brief Install a tick source; every interrupt-off section is then timed into the stats.
+ * @param tx: Transmitter
+ * @param ticks: Free-running counter (e.g. DWT->CYCCNT reader), NULL to stop measuring
+ */
+void ring_tx_set_tick_source(ring_tx_t *tx, ring_tx_ticks_fn ticks);
+
+/**
+ * @brief Queue bytes and start the engine if it is idle. Safe from tasks and ISRs.
+ * @param tx: Transmitter
+ * @param data: Bytes to send
+ * @param len: Number of bytes
+ * @return len if queued, 0 if the ring lacked room (the write is all-or-nothing so
+ *         log lines are never cut) or an ISR interrupted a task in the middle of its copy
+ */
+uint32_t ring_tx_write(ring_tx_t *tx, const void *data, uint32_t len);
+
+/**
+ * @brief Start a transfer if data is queued and the engine is idle.
+ * @param tx: Transmitter
+ * @note Useful after start_tx reported a failure (e.g. peripheral was in low-power mode).
+ */
+void ring_tx_kick(ring_tx_t *tx);
+
+/**
+ * @brief Driver notification that the span given to start_tx has been sent.
+ *        Releases the span and chains the next contiguous one (wrap-around included).
+ * @param tx: Transmitter
+ * @note Call from the DMA/UART TX-complete interrupt.
+ */
+void ring_tx_on_tx_complete(ring_tx_t *tx);
+
+/**
+ * @brief Bytes queued or in flight.
+ * @param tx: Transmitter
+ * @return Pending byte count
+ */
+uint32_t ring_tx_pending(const ring_tx_t *tx);
+
+/**
+ * @brief Check whether the engine is idle (nothing in flight).
+ * @param tx: Transmitter
+ * @return true if no transfer is running; useful before entering low-power modes
+ */
+bool ring_tx_is_idle(const ring_tx_t *tx);
+
+/**
+ * @brief Snapshot the counters.
+ * @param tx: Transmitter
+ * @param stats: Output
+ */
+void ring_tx_get_stats(const ring_tx_t *tx, ring_tx_stats_t *stats);
+
+#endif